@@ -0,0 +1,105 @@
+//
+//  atomicprocess.cpp
+//  states
+//
+//  Created by Daniel Pav on 10/19/26.
+//  Copyright © 2026 Daniel Pav. All rights reserved.
+//
+//  Times an AtomicProcess against a Process guarded by a mutex, with 1, 2, 4 and 8 threads all driving the same
+//  process.  Build from the top directory with:
+//      g++ -std=c++14 -O2 -Istates bench/atomicprocess.cpp states/*.cpp -pthread -o atomicprocess
+//
+
+#include "atomicprocess.hpp"
+#include "event.hpp"
+#include "link.hpp"
+#include "machine.hpp"
+#include "process.hpp"
+#include "state.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+static const char eTick[] = "Tick";
+
+using Tick = states::Event<eTick>;
+
+static const char sRed[] = "Red";
+static const char sGreen[] = "Green";
+static const char sAmber[] = "Amber";
+
+using Red = states::State<sRed>;
+using Green = states::State<sGreen>;
+using Amber = states::State<sAmber>;
+
+/* every state takes a tick, so a next only fails when another thread got there first */
+using MachineType =
+    states::Machine<states::Link<Red, Tick, Green>, states::Link<Green, Tick, Amber>, states::Link<Amber, Tick, Red>>;
+
+struct Data
+{
+};
+
+using AtomicType = states::AtomicProcess<MachineType, Red, Amber, Data, states::OpsNone>;
+using ProcessType = states::Process<MachineType, Red, Amber, Data>;
+
+/* runs body(thread) on the threads at once, returns the seconds until the last one finishes */
+template<typename TBody>
+static double race(size_t threads, TBody body)
+{
+    std::atomic<bool> go(false);
+    std::vector<std::thread> workers;
+    for (size_t t = 0; t < threads; ++t)
+        workers.emplace_back([&, t]() {
+            while (!go.load(std::memory_order_acquire))
+                std::this_thread::yield();
+            body(t);
+        });
+    const auto start = std::chrono::steady_clock::now();
+    go.store(true, std::memory_order_release);
+    for (std::thread& worker : workers)
+        worker.join();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char* argv[])
+{
+    const size_t ticks = (argc > 1) ? std::strtoull(argv[1], nullptr, 10) : 4000000;
+    std::cout << ticks << " ticks per thread, " << std::thread::hardware_concurrency() << " hardware threads"
+              << std::endl;
+    for (size_t threads = 1; threads <= 8; threads *= 2)
+    {
+        Data data;
+        AtomicType atomic(data);
+        atomic.start();
+        std::atomic<uint64_t> retries(0);
+        const double cas = race(threads, [&](size_t) {
+            uint64_t lost = 0;
+            for (size_t i = 0; i < ticks; ++i)
+                while (!atomic.next<Tick>())
+                    ++lost;
+            retries.fetch_add(lost, std::memory_order_relaxed);
+        });
+
+        ProcessType process(data);
+        process.start();
+        std::mutex mutex;
+        const double locked = race(threads, [&](size_t) {
+            for (size_t i = 0; i < ticks; ++i)
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                process.next<Tick>();
+            }
+        });
+
+        const double total = static_cast<double>(ticks * threads);
+        std::cout << threads << " threads: AtomicProcess " << total / cas / 1e6 << " M next/s ("
+                  << retries.load() << " retries), mutex " << total / locked / 1e6 << " M next/s" << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,139 @@
+//
+//  batchnext.cpp
+//  states
+//
+//  Created by Daniel Pav on 10/19/26.
+//  Copyright © 2026 Daniel Pav. All rights reserved.
+//
+//  Checks that the batch next gives the same result as a loop of next, also through TEnd and past rejected events, and
+//  times the two on the same input.  Build from the top directory with:
+//      g++ -std=c++14 -O2 -Istates bench/batchnext.cpp states/*.cpp -pthread -o batchnext
+//
+
+#include "event.hpp"
+#include "link.hpp"
+#include "machine.hpp"
+#include "process.hpp"
+#include "state.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+static const char eA[] = "A";
+static const char eB[] = "B";
+static const char eC[] = "C";
+
+using A = states::Event<eA>;
+using B = states::Event<eB>;
+using C = states::Event<eC>;
+
+static const char sS0[] = "S0";
+static const char sS1[] = "S1";
+static const char sS2[] = "S2";
+static const char sS3[] = "S3";
+static const char sEnd[] = "End";
+
+using S0 = states::State<sS0>;
+using S1 = states::State<sS1>;
+using S2 = states::State<sS2>;
+using S3 = states::State<sS3>;
+using End = states::State<sEnd>;
+
+/* finds A B B C, with C rejected in S0 and A rejected in S3.  End has links out, so a run goes on through it */
+using MachineType = states::Machine<
+    states::Link<S0, A, S1>, states::Link<S0, B, S0>,
+    states::Link<S1, A, S1>, states::Link<S1, B, S2>, states::Link<S1, C, S0>,
+    states::Link<S2, A, S1>, states::Link<S2, B, S3>, states::Link<S2, C, S0>,
+    states::Link<S3, B, S0>, states::Link<S3, C, End>,
+    states::Link<End, A, S1>, states::Link<End, B, S0>, states::Link<End, C, S0>>;
+
+struct Data
+{
+};
+
+using ProcessType = states::Process<MachineType, S0, End, Data>;
+using TEventNum = MachineType::TEventNum;
+
+/* what a run did: the events accepted and the state left in */
+struct Result
+{
+    size_t accepted;
+    size_t state;
+};
+
+/* gives every event to next */
+static Result loop(const std::vector<TEventNum>& events)
+{
+    Data d;
+    ProcessType p(d);
+    p.start();
+    size_t accepted = 0;
+    for (size_t i = 0; i < events.size(); ++i)
+        accepted += p.next(events[i]) ? 1 : 0;
+    return Result{accepted, p.state().get()};
+}
+
+/* gives the events to the batch next, passing over each event it rejects */
+static Result batch(const std::vector<TEventNum>& events)
+{
+    Data d;
+    ProcessType p(d);
+    p.start();
+    size_t accepted = 0;
+    for (size_t i = 0; i < events.size(); ++i)
+    {
+        const size_t done = p.next(events.data() + i, events.size() - i);
+        accepted += done;
+        i += done;
+    }
+    return Result{accepted, p.state().get()};
+}
+
+template<typename TRun>
+static double seconds(TRun run)
+{
+    const auto start = std::chrono::steady_clock::now();
+    run();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char* argv[])
+{
+    const size_t n = (argc > 1) ? std::strtoull(argv[1], nullptr, 10) : (size_t(1) << 26);
+    std::mt19937_64 random(7);
+    int failures = 0;
+
+    /* equal results on short random inputs, which go through End and have rejected events */
+    for (size_t size = 1; size < 4096; size += 37)
+    {
+        std::vector<TEventNum> events(size);
+        for (size_t i = 0; i < size; ++i)
+            events[i].set(static_cast<size_t>(random() % MachineType::eventCount));
+        const Result a = loop(events);
+        const Result b = batch(events);
+        if (a.accepted != b.accepted || a.state != b.state)
+        {
+            std::cout << "different result for " << size << " events" << std::endl;
+            ++failures;
+        }
+    }
+
+    /* times on a long input with no rejected events, the walk A B B C repeated through End */
+    std::vector<TEventNum> events(n);
+    const size_t walk[] = {0, 1, 1, 2};
+    for (size_t i = 0; i < n; ++i)
+        events[i].set(walk[i % 4]);
+    Result a{};
+    Result b{};
+    const double next = seconds([&]() { a = loop(events); });
+    const double batched = seconds([&]() { b = batch(events); });
+    std::cout << n << " events" << std::endl;
+    std::cout << "next:  " << next << " s, " << n / next / 1e6 << " M events/s" << std::endl;
+    std::cout << "batch: " << batched << " s, " << n / batched / 1e6 << " M events/s"
+              << ((a.accepted == b.accepted && a.state == b.state && a.accepted == n) ? "" : " DIFFERENT") << std::endl;
+    failures += (a.accepted == b.accepted && a.state == b.state && a.accepted == n) ? 0 : 1;
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,170 @@
+//
+//  epollserver.cpp
+//  states
+//
+//  Created by Daniel Pav on 10/19/26.
+//  Copyright © 2026 Daniel Pav. All rights reserved.
+//
+//  A loopback load test of EpollServer running the number parser of main.cpp for each connection.  Client threads
+//  first open many short connections, each sending one number, then stream long numbers on a few connections.  The
+//  server reports connections and events per second for each.  Linux only.  Build from the top directory with:
+//      g++ -std=c++14 -O2 -Istates bench/epollserver.cpp states/*.cpp -pthread -o epollserver
+//
+
+#include "epollserver.hpp"
+#include "event.hpp"
+#include "link.hpp"
+#include "machine.hpp"
+#include "process.hpp"
+#include "state.hpp"
+
+#include <arpa/inet.h>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <netinet/in.h>
+#include <string>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+// the parser of main.cpp, its ops reading the byte of the message instead of a string
+static const char eDigit[] = "Digit";
+static const char eDot[] = "Dot";
+static const char eDone[] = "Done";
+
+using Digit = states::Event<eDigit>;
+using Dot = states::Event<eDot>;
+using Done = states::Event<eDone>;
+
+struct Data
+{
+    const char* at_{nullptr};
+    std::string out_{};
+};
+
+static const char sStart[] = "Start";
+static const char sDigit1[] = "Digit1";
+static const char sDecimal[] = "Decimal";
+static const char sDigit2[] = "Digit2";
+static const char sEnd[] = "End";
+
+struct Consume
+{
+    void operator()(Data& d) { d.out_ += *d.at_; }
+};
+
+using Start = states::State<sStart>;
+using Digit1 = states::State<sDigit1, Consume>;
+using Decimal = states::State<sDecimal, Consume>;
+using Digit2 = states::State<sDigit2, Consume>;
+using End = states::State<sEnd>;
+
+using L1 = states::Link<Start, Digit, Digit1>;
+using L2 = states::Link<Digit1, Digit, Digit1>;
+using L3 = states::Link<Digit1, Dot, Decimal>;
+using L4 = states::Link<Digit1, Done, End>;
+using L5 = states::Link<Decimal, Digit, Digit2>;
+using L6 = states::Link<Decimal, Done, End>;
+using L7 = states::Link<Digit2, Digit, Digit2>;
+using L8 = states::Link<Digit2, Done, End>;
+
+using SM = states::Machine<L1, L2, L3, L4, L5, L6, L7, L8>;
+using Parser = states::Process<SM, Start, End, Data>;
+
+/* one byte is one message: a digit, a dot or the newline that ends the number */
+struct NumberHandler
+{
+    void open(Data& d, int) { d.out_.clear(); }
+
+    bool classify(Data&, const char*& in, const char*, Parser::TEventNum& event)
+    {
+        const char c = *in++;
+        event = Parser::TEventNum();
+        if (c >= '0' && c <= '9')
+            event.set<Digit>();
+        else if (c == '.')
+            event.set<Dot>();
+        else if (c == '\n')
+            event.set<Done>();
+        return true;
+    }
+
+    void message(Data& d, const char* begin, const char*) { d.at_ = begin; }
+
+    void close(Data&) {}
+};
+
+using Server = states::EpollServer<Parser, NumberHandler>;
+
+/* connects to the port, sends the text and waits for the server to close the connection */
+static bool session(uint16_t port, const std::string& text)
+{
+    const int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0)
+        return false;
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    bool ok = ::connect(fd, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) == 0;
+    for (size_t sent = 0; ok && sent < text.size();)
+    {
+        const ssize_t n = ::send(fd, text.data() + sent, text.size() - sent, MSG_NOSIGNAL);
+        ok = n > 0;
+        sent += ok ? static_cast<size_t>(n) : 0;
+    }
+    char buffer[64];
+    while (ok && ::recv(fd, buffer, sizeof(buffer), 0) > 0)
+    {
+    }
+    ::close(fd);
+    return ok;
+}
+
+/* runs the clients, each making sessions sessions of the text, against the server until they are all done */
+static void load(Server& server, const char* name, size_t clients, size_t sessions, const std::string& text)
+{
+    const Server::Stats before = server.stats();
+    std::atomic<size_t> running(clients);
+    std::atomic<size_t> failed(0);
+    std::vector<std::thread> threads;
+    const auto start = std::chrono::steady_clock::now();
+    for (size_t c = 0; c < clients; ++c)
+        threads.emplace_back([&]() {
+            for (size_t s = 0; s < sessions; ++s)
+                if (!session(server.port(), text))
+                    failed.fetch_add(1);
+            running.fetch_sub(1);
+        });
+    while (running.load() != 0 || server.connections() != 0)
+        server.poll(1);
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    for (std::thread& thread : threads)
+        thread.join();
+    const Server::Stats& after = server.stats();
+    const double accepted = static_cast<double>(after.accepted - before.accepted);
+    const double events = static_cast<double>(after.events - before.events);
+    std::cout << name << ": " << clients << " clients x " << sessions << " sessions of " << text.size()
+              << " bytes in " << seconds << " s, " << accepted / seconds << " connections/s, " << events / seconds / 1e6
+              << " M events/s, " << (after.rejected - before.rejected) << " rejected, " << failed.load() << " failed"
+              << std::endl;
+}
+
+int main(int argc, char* argv[])
+{
+    const size_t clients = (argc > 1) ? std::strtoull(argv[1], nullptr, 10) : 8;
+    Server server(NumberHandler(), 4096);
+    if (!server.listen("127.0.0.1", 0, 1024))
+    {
+        std::cout << "cannot listen" << std::endl;
+        return 1;
+    }
+    std::cout << std::thread::hardware_concurrency() << " hardware threads" << std::endl;
+    load(server, "short", clients, 2000, "31415.9265\n");
+    std::string digits(size_t(1) << 22, '7');
+    load(server, "stream", clients, 4, digits + ".5\n");
+    return 0;
+}
@@ -0,0 +1,133 @@
+//
+//  parallelrun.cpp
+//  states
+//
+//  Created by Daniel Pav on 10/19/26.
+//  Copyright © 2026 Daniel Pav. All rights reserved.
+//
+//  Checks that ParallelRun gives the same result as next over the same input and times it against next with 1, 2, 4
+//  and 8 threads.  Build from the top directory with:
+//      g++ -std=c++14 -O2 -Istates bench/parallelrun.cpp states/*.cpp -pthread -o parallelrun
+//
+
+#include "event.hpp"
+#include "link.hpp"
+#include "machine.hpp"
+#include "parallelrun.hpp"
+#include "process.hpp"
+#include "state.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+static const char eA[] = "A";
+static const char eB[] = "B";
+static const char eC[] = "C";
+
+using A = states::Event<eA>;
+using B = states::Event<eB>;
+using C = states::Event<eC>;
+
+static const char sS0[] = "S0";
+static const char sS1[] = "S1";
+static const char sS2[] = "S2";
+static const char sS3[] = "S3";
+static const char sEnd[] = "End";
+
+using S0 = states::State<sS0>;
+using S1 = states::State<sS1>;
+using S2 = states::State<sS2>;
+using S3 = states::State<sS3>;
+using End = states::State<sEnd>;
+
+/* finds A B B C, with C rejected in S0 and A rejected in S3 */
+using MachineType = states::Machine<
+    states::Link<S0, A, S1>, states::Link<S0, B, S0>,
+    states::Link<S1, A, S1>, states::Link<S1, B, S2>, states::Link<S1, C, S0>,
+    states::Link<S2, A, S1>, states::Link<S2, B, S3>, states::Link<S2, C, S0>,
+    states::Link<S3, B, S0>, states::Link<S3, C, End>,
+    states::Link<End, A, S1>, states::Link<End, B, S0>, states::Link<End, C, S0>>;
+
+struct Data
+{
+};
+
+using ProcessType = states::Process<MachineType, S0, End, Data>;
+using RunType = states::ParallelRun<MachineType, S0, End>;
+using TEventNum = MachineType::TEventNum;
+
+/* the result of next over every event, as ParallelRun gives it */
+static RunType::Result sequential(const std::vector<TEventNum>& events)
+{
+    Data d;
+    ProcessType p(d);
+    p.start();
+    RunType::Result result{{}, RunType::npos, RunType::npos};
+    for (size_t i = 0; i < events.size(); ++i)
+    {
+        if (!p.next(events[i]))
+        {
+            if (result.rejected == RunType::npos)
+                result.rejected = i;
+        }
+        else if (result.accepted == RunType::npos && p.at<End>())
+            result.accepted = i;
+    }
+    result.state = p.state();
+    return result;
+}
+
+static bool same(const RunType::Result& a, const RunType::Result& b)
+{
+    return a.state.get() == b.state.get() && a.accepted == b.accepted && a.rejected == b.rejected;
+}
+
+template<typename TRun>
+static double seconds(TRun run)
+{
+    const auto start = std::chrono::steady_clock::now();
+    run();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char* argv[])
+{
+    const size_t n = (argc > 1) ? std::strtoull(argv[1], nullptr, 10) : (size_t(1) << 26);
+    std::mt19937_64 random(7);
+    std::vector<TEventNum> events(n);
+    int failures = 0;
+
+    /* equal results on short inputs cut at every size around the chunk boundaries */
+    for (size_t size = 1; size < 4096; size += 37)
+    {
+        for (size_t i = 0; i < size; ++i)
+            events[i].set(static_cast<size_t>(random() % MachineType::eventCount));
+        const std::vector<TEventNum> input(events.begin(), events.begin() + size);
+        for (size_t threads = 1; threads <= 8; threads *= 2)
+            if (!same(sequential(input), RunType(threads, 64).run(input.data(), size)))
+            {
+                std::cout << "different result for " << size << " events on " << threads << " threads" << std::endl;
+                ++failures;
+            }
+    }
+
+    /* times on the long input */
+    for (size_t i = 0; i < n; ++i)
+        events[i].set(static_cast<size_t>(random() % MachineType::eventCount));
+    RunType::Result expected{};
+    const double base = seconds([&]() { expected = sequential(events); });
+    std::cout << n << " events, " << std::thread::hardware_concurrency() << " hardware threads" << std::endl;
+    std::cout << "next:       " << base << " s" << std::endl;
+    for (size_t threads = 1; threads <= 8; threads *= 2)
+    {
+        RunType::Result result{};
+        const double time = seconds([&]() { result = RunType(threads).run(events.data(), n); });
+        std::cout << threads << " threads: " << time << " s, " << base / time << "x"
+                  << (same(result, expected) ? "" : " DIFFERENT") << std::endl;
+        failures += same(result, expected) ? 0 : 1;
+    }
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,152 @@
+//
+//  weightedmachine.cpp
+//  states
+//
+//  Created by Daniel Pav on 10/19/26.
+//  Copyright © 2026 Daniel Pav. All rights reserved.
+//
+//  Times a Machine against the WeightedMachine of the same links, with weights from a LinkProfile of the same
+//  workload, on a stream where a few links carry almost every event.  Build from the top directory with:
+//      g++ -std=c++14 -O2 -Istates bench/weightedmachine.cpp states/*.cpp -o weightedmachine
+//
+
+#include "event.hpp"
+#include "link.hpp"
+#include "linkprofile.hpp"
+#include "machine.hpp"
+#include "process.hpp"
+#include "state.hpp"
+#include "weightedmachine.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+static const char eRequest[] = "Request";
+static const char eData[] = "Data";
+static const char eFinish[] = "Finish";
+static const char eFail[] = "Fail";
+static const char eRestart[] = "Restart";
+
+using Request = states::Event<eRequest>;
+using Data = states::Event<eData>;
+using Finish = states::Event<eFinish>;
+using Fail = states::Event<eFail>;
+using Restart = states::Event<eRestart>;
+
+static const char sIdle[] = "Idle";
+static const char sBusy[] = "Busy";
+static const char sError[] = "Error";
+
+using Idle = states::State<sIdle>;
+using Busy = states::State<sBusy>;
+using Error = states::State<sError>;
+
+/* every state has a link for every event, the links in the order of the machine */
+using MachineType = states::Machine<
+    states::Link<Idle, Data, Error>, states::Link<Idle, Finish, Error>, states::Link<Idle, Fail, Error>,
+    states::Link<Idle, Restart, Idle>, states::Link<Busy, Request, Error>, states::Link<Busy, Restart, Idle>,
+    states::Link<Error, Request, Error>, states::Link<Error, Data, Error>, states::Link<Error, Finish, Error>,
+    states::Link<Error, Fail, Error>, states::Link<Idle, Request, Busy>, states::Link<Busy, Fail, Error>,
+    states::Link<Error, Restart, Idle>, states::Link<Busy, Finish, Idle>, states::Link<Busy, Data, Busy>>;
+
+/* the weights as LinkProfile::emit writes them for the workload below */
+using Weights = states::LinkWeights<0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 42, 1, 1, 41, 1000>;
+using WeightedType = states::WeightedMachine<MachineType, Weights>;
+
+struct Session
+{
+};
+
+using TEventNum = MachineType::TEventNum;
+
+/* a session sends a request, about 24 data and a finish, with one in a hundred failing and restarting */
+static std::vector<TEventNum> workload(size_t n)
+{
+    std::mt19937_64 random(11);
+    std::vector<TEventNum> events(n);
+    size_t state = 0;
+    for (TEventNum& event : events)
+    {
+        const unsigned roll = static_cast<unsigned>(random() % 1000);
+        if (state == 0)
+        {
+            event.set<Request>();
+            state = 1;
+        }
+        else if (state == 2)
+        {
+            event.set<Restart>();
+            state = 0;
+        }
+        else if (roll < 40)
+        {
+            event.set<Finish>();
+            state = 0;
+        }
+        else if (roll < 41)
+        {
+            event.set<Fail>();
+            state = 2;
+        }
+        else
+            event.set<Data>();
+    }
+    return events;
+}
+
+/* runs the events on a process of the machine, returns the seconds taken and the number of links followed */
+template<typename TMachine>
+static double run(const std::vector<TEventNum>& events, size_t& followed)
+{
+    Session session;
+    states::Process<TMachine, Idle, Error, Session> p(session);
+    p.start();
+    followed = 0;
+    const auto start = std::chrono::steady_clock::now();
+    for (const TEventNum& event : events)
+        followed += p.next(event) ? 1 : 0;
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    followed += p.state().get();
+    return seconds;
+}
+
+int main(int argc, char* argv[])
+{
+    const size_t n = (argc > 1) ? std::strtoull(argv[1], nullptr, 10) : (size_t(1) << 27);
+    const std::vector<TEventNum> events = workload(n);
+
+    /* the profile the weights came from */
+    states::LinkProfile<MachineType> profile;
+    {
+        Session session;
+        states::Process<MachineType, Idle, Error, Session, states::LinkCounter<MachineType>> p(
+            session, states::LinkCounter<MachineType>(profile));
+        p.start();
+        for (size_t i = 0; i < n && i < (size_t(1) << 20); ++i)
+            p.next(events[i]);
+    }
+    profile.emit(std::cout, "Weights");
+
+    size_t plain = 0;
+    size_t weighted = 0;
+    double best[2] = {1e9, 1e9};
+    for (int round = 0; round < 5; ++round)
+    {
+        const double a = run<MachineType>(events, plain);
+        const double b = run<WeightedType>(events, weighted);
+        best[0] = (a < best[0]) ? a : best[0];
+        best[1] = (b < best[1]) ? b : best[1];
+    }
+    std::cout << n << " events, best of 5" << std::endl;
+    std::cout << "Machine:         " << best[0] << " s, " << n / best[0] / 1e6 << " M events/s" << std::endl;
+    std::cout << "WeightedMachine: " << best[1] << " s, " << n / best[1] / 1e6 << " M events/s" << std::endl;
+    if (plain != weighted)
+    {
+        std::cout << "different results" << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,247 @@
+//
+//  anyprocess.hpp
+//  states
+//
+//  Created by Daniel Pav on 10/19/26.
+//  Copyright © 2026 Daniel Pav. All rights reserved.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "named.hpp"
+#include "typelist.hpp"
+#include "umlvisitor.hpp"
+
+namespace states
+{
+/* an id of an event that is the same in every machine using the event: the address of its name */
+class EventId
+{
+public:
+    /* creates the id of no event */
+    constexpr EventId() : name_(nullptr) {}
+
+public:
+    /* returns the id of the event TEvent */
+    template<typename TEvent>
+    static constexpr EventId of()
+    {
+        return EventId(TEvent::name());
+    }
+
+    /* returns the name of the event, nullptr for no event */
+    constexpr const char* name() const { return name_; }
+
+    constexpr bool operator==(const EventId& other) const { return name_ == other.name_; }
+    constexpr bool operator!=(const EventId& other) const { return name_ != other.name_; }
+
+private:
+    constexpr explicit EventId(const char* name) : name_(name) {}
+
+private:
+    const char* name_;
+};
+
+/* holds a process of any type, so that processes of different machines can be kept and driven together.  there are no
+ virtual functions: emplace picks a table of functions for the type of process, which is the only thing the handle
+ points to besides the process.  the process is constructed in a buffer of TSize bytes inside the handle, or on the
+ heap if it does not fit.  events are given by name, which is compared as text, or by EventId, which is looked up in
+ the events of the machine by address.  to skip the look up, resolve the event once with eventIndex and give the index
+ to nextIndex, which is a single call through the table.  an event the process does not know is rejected like an event
+ without a link.  an empty handle rejects everything and is never done.  visit runs Process::visit with a TVisitor.
+ */
+template<size_t TSize = 64, typename TVisitor = UmlVisitor>
+class AnyProcess
+{
+public:
+    /* creates an empty handle */
+    AnyProcess() : table_(&emptyTable_) {}
+    /* destroys the process */
+    ~AnyProcess() { clear(); }
+
+private:
+    AnyProcess(const AnyProcess&) = delete;
+    AnyProcess(AnyProcess&&) = delete;
+    AnyProcess& operator=(const AnyProcess&) = delete;
+    AnyProcess& operator=(AnyProcess&&) = delete;
+
+private:
+    /* the functions for one type of process */
+    struct Table
+    {
+        void (*destroy)(void*);
+        void (*reset)(void*);
+        void (*start)(void*);
+        bool (*nextName)(void*, const char*);
+        bool (*nextId)(void*, const char*);
+        bool (*nextIndex)(void*, size_t);
+        size_t (*find)(const char*);
+        bool (*done)(const void*);
+        bool (*invoke)(void*);
+        void (*visit)(TVisitor&);
+    };
+
+    /* the process is in the buffer if it fits */
+    template<typename TProcess>
+    using TInline = std::integral_constant<bool, sizeof(TProcess) <= TSize &&
+                                                     alignof(TProcess) <= alignof(std::max_align_t)>;
+
+    /* the functions for a process of type TProcess */
+    template<typename TProcess>
+    struct Functions
+    {
+        using TMachine = typename TProcess::TMachineType;
+
+        static TProcess& get(void* buffer, std::true_type) { return *static_cast<TProcess*>(buffer); }
+        static TProcess& get(void* buffer, std::false_type) { return **static_cast<TProcess**>(buffer); }
+        static TProcess& get(void* buffer) { return get(buffer, TInline<TProcess>()); }
+        static const TProcess& get(const void* buffer) { return get(const_cast<void*>(buffer)); }
+
+        static void destroy(void* buffer, std::true_type) { get(buffer).~TProcess(); }
+        static void destroy(void* buffer, std::false_type) { delete &get(buffer); }
+        static void destroy(void* buffer) { destroy(buffer, TInline<TProcess>()); }
+
+        static void reset(void* buffer) { get(buffer).reset(); }
+        static void start(void* buffer) { get(buffer).start(); }
+
+        static bool nextIndex(void* buffer, size_t index)
+        {
+            typename TMachine::TEventNum event;
+            return event.set(index) && get(buffer).next(event);
+        }
+
+        static bool nextName(void* buffer, const char* name)
+        {
+            return nextIndex(buffer, NamedIndex<typename TMachine::TEventTypes>::find(name));
+        }
+
+        static bool nextId(void* buffer, const char* name) { return nextIndex(buffer, find(name)); }
+
+        static size_t find(const char* name) { return NamedIndex<typename TMachine::TEventTypes>::findSame(name); }
+
+        static bool done(const void* buffer) { return get(buffer).done(); }
+        static bool invoke(void* buffer) { return get(buffer).invoke(); }
+        static void visit(TVisitor& visitor) { TProcess::visit(visitor); }
+
+        static const Table table;
+    };
+
+    /* the functions of an empty handle */
+    static void emptyDestroy(void*) {}
+    static void emptyReset(void*) {}
+    static void emptyStart(void*) {}
+    static bool emptyNext(void*, const char*) { return false; }
+    static bool emptyNextIndex(void*, size_t) { return false; }
+    static size_t emptyFind(const char*) { return TypeListIndexBase::npos; }
+    static bool emptyDone(const void*) { return false; }
+    static bool emptyInvoke(void*) { return false; }
+    static void emptyVisit(TVisitor&) {}
+
+    static const Table emptyTable_;
+
+private:
+    /* constructs the process in the buffer */
+    template<typename TProcess, typename... TArgs>
+    TProcess& construct(std::true_type, TArgs&&... args)
+    {
+        return *new (buffer_) TProcess(std::forward<TArgs>(args)...);
+    }
+
+    /* constructs the process on the heap, keeping its address in the buffer */
+    template<typename TProcess, typename... TArgs>
+    TProcess& construct(std::false_type, TArgs&&... args)
+    {
+        TProcess* process = new TProcess(std::forward<TArgs>(args)...);
+        *reinterpret_cast<TProcess**>(buffer_) = process;
+        return *process;
+    }
+
+public:
+    /* replaces the process with a TProcess constructed from the arguments, which is returned to start it */
+    template<typename TProcess, typename... TArgs>
+    TProcess& emplace(TArgs&&... args)
+    {
+        clear();
+        TProcess& process = construct<TProcess>(TInline<TProcess>(), std::forward<TArgs>(args)...);
+        table_ = &Functions<TProcess>::table;
+        return process;
+    }
+
+    /* destroys the process, leaving the handle empty */
+    void clear()
+    {
+        const Table* table = table_;
+        table_ = &emptyTable_;
+        table->destroy(buffer_);
+    }
+
+    /* returns true if there is no process */
+    bool empty() const { return table_ == &emptyTable_; }
+
+    /* returns the process if it is a TProcess, nullptr if not */
+    template<typename TProcess>
+    TProcess* get()
+    {
+        return (table_ == &Functions<TProcess>::table) ? &Functions<TProcess>::get(buffer_) : nullptr;
+    }
+
+    /* resets the process */
+    void reset() { table_->reset(buffer_); }
+
+    /* starts the process */
+    void start() { table_->start(buffer_); }
+
+    /* handles the event with the name, returns true if a link was followed */
+    bool next(const char* name) { return table_->nextName(buffer_, name); }
+
+    /* handles the event with the id, returns true if a link was followed */
+    bool next(const EventId& event) { return table_->nextId(buffer_, event.name()); }
+
+    /* returns the index of the event with the id in the machine of the process, npos if it does not have it or the
+     handle is empty.  the index stays good for the process until emplace or clear */
+    size_t eventIndex(const EventId& event) const { return table_->find(event.name()); }
+
+    /* handles the event with the index returned by eventIndex, returns true if a link was followed */
+    bool nextIndex(size_t index) { return table_->nextIndex(buffer_, index); }
+
+    /* handles the event TEvent, returns true if a link was followed */
+    template<typename TEvent>
+    bool next()
+    {
+        return next(EventId::template of<TEvent>());
+    }
+
+    /* returns true if the process is at its end state */
+    bool done() const { return table_->done(buffer_); }
+
+    /* invokes the op of the current state, returns true if started */
+    bool invoke() { return table_->invoke(buffer_); }
+
+    /* visits the machine of the process, an empty handle visits nothing */
+    void visit(TVisitor& visitor) const { table_->visit(visitor); }
+
+private:
+    /* the functions for the process */
+    const Table* table_;
+    /* the process, or its address if it does not fit */
+    alignas(std::max_align_t) unsigned char buffer_[(TSize < sizeof(void*)) ? sizeof(void*) : TSize];
+};
+
+/* definition of the table for a type of process */
+template<size_t TSize, typename TVisitor>
+template<typename TProcess>
+const typename AnyProcess<TSize, TVisitor>::Table AnyProcess<TSize, TVisitor>::Functions<TProcess>::table = {
+    &destroy, &reset, &start, &nextName, &nextId, &nextIndex, &find, &done, &invoke, &visit};
+
+/* definition of the table of an empty handle */
+template<size_t TSize, typename TVisitor>
+const typename AnyProcess<TSize, TVisitor>::Table AnyProcess<TSize, TVisitor>::emptyTable_ = {
+    &emptyDestroy, &emptyReset, &emptyStart, &emptyNext, &emptyNext, &emptyNextIndex, &emptyFind, &emptyDone,
+    &emptyInvoke, &emptyVisit};
+
+} // namespace states
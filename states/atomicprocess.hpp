@@ -0,0 +1,191 @@
+//
+//  atomicprocess.hpp
+//  states
+//
+//  Created by Daniel Pav on 10/19/26.
+//  Copyright © 2026 Daniel Pav. All rights reserved.
+//
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <type_traits>
+
+#include "invoker.hpp"
+#include "process.hpp"
+#include "typelist.hpp"
+
+namespace states
+{
+/* the ops of a transition run before the new state is committed.  they may run for a transition that then loses the
+ race and is not committed, so they must be safe to run twice for the same state */
+struct OpsBeforeCommit
+{
+};
+
+/* the ops of a transition run after the new state is committed, only by the thread that won the race.  another thread
+ may see the new state before they finish */
+struct OpsAfterCommit
+{
+};
+
+/* no ops are run, the process only tracks the state */
+struct OpsNone
+{
+};
+
+/* a process whose state may be advanced by several threads at once without a lock.  the state is an atomic index.  next
+ reads the state, finds the link for the event from it and commits the state the link goes to with a compare and
+ exchange from the state that was read.  next returns false if there is no link or if another thread changed the state
+ first; the event can then be retried or dropped.  TPolicy decides when the link and state ops run (see OpsBeforeCommit,
+ OpsAfterCommit and OpsNone).  the data is shared by every thread, so ops that run must be safe to run concurrently.
+ start and reset are not meant to race with next.
+ */
+template<typename TMachine, typename TBegin, typename TEnd, typename TData, typename TPolicy = OpsAfterCommit>
+class AtomicProcess
+{
+public:
+    /* creates a process with no state, storing a reference to the data */
+    AtomicProcess(TData& data) : state_(npos), data_(data) {}
+    /* destroys the process */
+    ~AtomicProcess() = default;
+
+private:
+    AtomicProcess(const AtomicProcess&) = delete;
+    AtomicProcess(AtomicProcess&&) = delete;
+    AtomicProcess& operator=(const AtomicProcess&) = delete;
+    AtomicProcess& operator=(AtomicProcess&&) = delete;
+
+public:
+    /* the state num type using the states from the machine given */
+    using TStateNum = typename TMachine::TStateNum;
+    /* the event num type using the events from the machine given */
+    using TEventNum = typename TMachine::TEventNum;
+    /* asserts that the begin state is in the from states */
+    static_assert(TypeListContains<typename TMachine::TFromStateTypes, TBegin>::value, "");
+    /* asserts that the end state is in the to states */
+    static_assert(TypeListContains<typename TMachine::TToStateTypes, TEnd>::value, "");
+    /* make sure the end is reachable from the begin */
+    static_assert(Reachable<TMachine, TBegin, TEnd>::value, "End not reachable from Begin");
+
+private:
+    /* no state */
+    static const constexpr size_t npos = TypeListIndexBase::npos;
+    /* index of the begin state */
+    static const constexpr size_t begin = TypeListIndex<typename TMachine::TStateTypes, TBegin>::index;
+    /* index of the end state */
+    static const constexpr size_t end = TypeListIndex<typename TMachine::TStateTypes, TEnd>::index;
+
+    /* returns the state num of the index */
+    static TStateNum stateNum(size_t index)
+    {
+        TStateNum state;
+        state.set(index);
+        return state;
+    }
+
+    /* commits the state from from to to */
+    bool commit(size_t from, size_t to)
+    {
+        return state_.compare_exchange_strong(from, to, std::memory_order_acq_rel, std::memory_order_acquire);
+    }
+
+    /* runs the ops of the link from the state from for the event */
+    void runOps(size_t from, const TEventNum& event)
+    {
+        TStateNum state = stateNum(from);
+        TMachine::handle(state, event, data_);
+    }
+
+    /* runs the ops, then commits */
+    bool nextImpl(size_t from, size_t to, const TEventNum& event, OpsBeforeCommit)
+    {
+        runOps(from, event);
+        return commit(from, to);
+    }
+
+    /* commits, then runs the ops if committed */
+    bool nextImpl(size_t from, size_t to, const TEventNum& event, OpsAfterCommit)
+    {
+        if (!commit(from, to))
+            return false;
+        runOps(from, event);
+        return true;
+    }
+
+    /* commits without ops */
+    bool nextImpl(size_t from, size_t to, const TEventNum&, OpsNone) { return commit(from, to); }
+
+    /* runs the op of the begin state */
+    void startOps(OpsBeforeCommit) { TMachine::process(stateNum(begin), data_); }
+    void startOps(OpsAfterCommit) { TMachine::process(stateNum(begin), data_); }
+    void startOps(OpsNone) {}
+
+public:
+    /* sets the process to no-state, equivalent to newly constructed */
+    void reset() { state_.store(npos, std::memory_order_release); }
+
+    /* sets the state to the TBegin state, running its op unless the policy is OpsNone */
+    void start()
+    {
+        state_.store(begin, std::memory_order_release);
+        startOps(TPolicy());
+    }
+
+    /* follows the link from the current state for the event.  returns false if there is no state, no link or another
+     thread changed the state first */
+    bool next(const TEventNum& event)
+    {
+        const size_t from = state_.load(std::memory_order_acquire);
+        const size_t to = TMachine::target(from, event.get());
+        return (to != npos) ? nextImpl(from, to, event, TPolicy()) : false;
+    }
+
+    /* follows the link for the event TEvent as above */
+    template<typename TEvent>
+    typename std::enable_if<TypeListContains<typename TMachine::TEventTypes, TEvent>::value, bool>::type next()
+    {
+        TEventNum event{};
+        event.template set<TEvent>();
+        return next(event);
+    }
+
+    /* returns the current state */
+    TStateNum state() const { return stateNum(state_.load(std::memory_order_acquire)); }
+
+    /* returns true if at the state specified */
+    template<typename TState>
+    bool at() const
+    {
+        return state().template is<TState>();
+    }
+
+    /* returns true if the current state has a link for the event, without following it */
+    bool accepts(const TEventNum& event) const { return TMachine::accepts(state(), event); }
+
+    /* invokes the state op for the current state, returns true if at a state */
+    bool invoke()
+    {
+        const TStateNum current = state();
+        return current.valid() ? TMachine::process(current, data_) : false;
+    }
+
+    /* returns true if at the TEnd state */
+    bool done() const { return state_.load(std::memory_order_acquire) == end; }
+
+    /* visits the process as a Process */
+    template<typename TVisitor>
+    static void visit(TVisitor& visitor)
+    {
+        Process<TMachine, TBegin, TEnd, TData>::visit(visitor);
+    }
+
+private:
+    /* index of the current state, npos if reset */
+    std::atomic<size_t> state_;
+    /* reference to the data to be operated on during processing */
+    TData& data_;
+};
+
+} // namespace states
@@ -0,0 +1,100 @@
+//
+//  bitset.hpp
+//  states
+//
+//  Created by Daniel Pav on 10/19/26.
+//  Copyright © 2026 Daniel Pav. All rights reserved.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace states
+{
+/* a fixed set of N bits in 64 bit words that, unlike std::bitset, can be built and combined in constant expressions.
+ bit i is bit (i % 64) of word (i / 64).  bits past N are always 0 */
+template<size_t N>
+class BitSet
+{
+public:
+    /* number of bits */
+    static const constexpr size_t size = N;
+    /* number of words, at least 1 */
+    static const constexpr size_t words = (N + 63) / 64 ? (N + 63) / 64 : 1;
+
+public:
+    /* returns true if bit i is set */
+    constexpr bool test(size_t i) const { return (i < N) && ((words_[i / 64] >> (i % 64)) & 1) != 0; }
+    /* sets bit i */
+    constexpr void set(size_t i)
+    {
+        if (i < N)
+            words_[i / 64] |= uint64_t(1) << (i % 64);
+    }
+    /* clears bit i */
+    constexpr void reset(size_t i)
+    {
+        if (i < N)
+            words_[i / 64] &= ~(uint64_t(1) << (i % 64));
+    }
+    /* returns the word at index w */
+    constexpr uint64_t word(size_t w) const { return words_[w]; }
+
+    /* returns true if any bit is set */
+    constexpr bool any() const
+    {
+        for (size_t w = 0; w < words; ++w)
+            if (words_[w] != 0)
+                return true;
+        return false;
+    }
+    /* returns true if no bit is set */
+    constexpr bool none() const { return !any(); }
+
+    /* returns the number of bits set */
+    constexpr size_t count() const
+    {
+        size_t n = 0;
+        for (size_t w = 0; w < words; ++w)
+            for (uint64_t bits = words_[w]; bits != 0; bits &= bits - 1)
+                ++n;
+        return n;
+    }
+
+public:
+    /* sets the bits that are set in other */
+    constexpr BitSet& operator|=(const BitSet& other)
+    {
+        for (size_t w = 0; w < words; ++w)
+            words_[w] |= other.words_[w];
+        return *this;
+    }
+    /* clears the bits that are not set in other */
+    constexpr BitSet& operator&=(const BitSet& other)
+    {
+        for (size_t w = 0; w < words; ++w)
+            words_[w] &= other.words_[w];
+        return *this;
+    }
+    /* returns the bits set in either */
+    friend constexpr BitSet operator|(BitSet lhs, const BitSet& rhs) { return lhs |= rhs; }
+    /* returns the bits set in both */
+    friend constexpr BitSet operator&(BitSet lhs, const BitSet& rhs) { return lhs &= rhs; }
+    /* returns true if the same bits are set */
+    friend constexpr bool operator==(const BitSet& lhs, const BitSet& rhs)
+    {
+        for (size_t w = 0; w < words; ++w)
+            if (lhs.words_[w] != rhs.words_[w])
+                return false;
+        return true;
+    }
+    /* returns true if different bits are set */
+    friend constexpr bool operator!=(const BitSet& lhs, const BitSet& rhs) { return !(lhs == rhs); }
+
+private:
+    /* the bits */
+    uint64_t words_[words]{};
+};
+} // namespace states
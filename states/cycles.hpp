@@ -0,0 +1,39 @@
+//
+//  cycles.hpp
+//  states
+//
+//  Created by Daniel Pav on 10/19/26.
+//  Copyright © 2026 Daniel Pav. All rights reserved.
+//
+
+#pragma once
+
+#include <cstdint>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#define STATES_HAS_RDTSC 1
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define STATES_HAS_RDTSC 1
+#else
+#include <chrono>
+#endif
+
+namespace states
+{
+/* a cheap, monotonically increasing tick counter.  uses the time stamp counter where the cpu has one and the steady
+ clock otherwise.  ticks are only meaningful relative to each other on the same machine */
+struct Cycles
+{
+    /* returns the current tick count */
+    static uint64_t now()
+    {
+#if defined(STATES_HAS_RDTSC)
+        return __rdtsc();
+#else
+        return static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+    }
+};
+} // namespace states
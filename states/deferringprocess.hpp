@@ -0,0 +1,194 @@
+//
+//  deferringprocess.hpp
+//  states
+//
+//  Created by Daniel Pav on 10/19/26.
+//  Copyright © 2026 Daniel Pav. All rights reserved.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+#include "state.hpp"
+#include "typelist.hpp"
+
+namespace states
+{
+/* the set of events of TMachine in the list TDeferred (see Deferred), events not of the machine are left out */
+template<typename TMachine, typename TDeferred>
+struct DeferMask;
+
+template<typename TMachine, typename... TEvents>
+struct DeferMask<TMachine, Deferred<TEvents...>>
+{
+    /* returns the set with a bit for each event */
+    static constexpr typename TMachine::TEventMask make()
+    {
+        using TEventTypes = typename TMachine::TEventTypes;
+        typename TMachine::TEventMask mask{};
+        const size_t events[] = {TypeListIndexBase::npos, TypeListIndex<TEventTypes, TEvents>::index...};
+        for (size_t i = 1; i < sizeof...(TEvents) + 1; ++i)
+            mask.set(events[i]);
+        return mask;
+    }
+};
+
+/* the events deferred by each state of TMachine, with a last, empty row for no-state */
+template<typename TMachine>
+struct DeferTable
+{
+    /* the set of events of the machine */
+    using TEventMask = typename TMachine::TEventMask;
+
+    TEventMask masks[TMachine::stateCount + 1];
+
+    /* state case for building the table, sets the row of the first state then the others */
+    template<typename TList>
+    static constexpr void fill(DeferTable& table, size_t state, const TList*)
+    {
+        table.masks[state] = DeferMask<TMachine, typename TList::TCurrentType::TDeferredType>::make();
+        fill(table, state + 1, static_cast<const typename TList::TNextType*>(nullptr));
+    }
+
+    /* base case for building the table, no more states */
+    static constexpr void fill(DeferTable&, size_t, const TypeListEnd*) {}
+
+    /* builds the table from the states of the machine */
+    static constexpr DeferTable make()
+    {
+        DeferTable table{};
+        fill(table, 0, static_cast<const typename TMachine::TStateTypes*>(nullptr));
+        return table;
+    }
+};
+
+/* a process of type TProcess that keeps the events its state defers.  an event the state has no link for, but defers
+ (see Deferred), is kept in a buffer of up to TCapacity events held in this, and next returns true.  after every
+ transition the events kept are looked at in the order they came in against two sets of the new state, the events it
+ accepts and the events it defers: the first it accepts is given to the process, which starts the look again from the
+ new state, and the ones it neither accepts nor defers are dropped.  only bits are tested, no event is tried on the
+ process.  an event the state neither accepts nor defers, or that does not fit in the buffer, is rejected and next
+ returns false.  TProcess is a Process or a PushdownProcess, constructed with the arguments given to this.
+ */
+template<typename TProcess, size_t TCapacity = 8>
+class DeferringProcess
+{
+public:
+    /* the machine */
+    using TMachineType = typename TProcess::TMachineType;
+    /* the state num type */
+    using TStateNum = typename TProcess::TStateNum;
+    /* the event num type */
+    using TEventNum = typename TProcess::TEventNum;
+    /* the set of events of the machine */
+    using TEventMask = typename TMachineType::TEventMask;
+    /* the most events kept */
+    static const constexpr size_t capacity = TCapacity;
+
+    /* creates the process with the arguments */
+    template<typename... TArgs>
+    DeferringProcess(TArgs&&... args) : process_(std::forward<TArgs>(args)...), count_(0)
+    {
+    }
+
+private:
+    DeferringProcess(const DeferringProcess&) = delete;
+    DeferringProcess& operator=(const DeferringProcess&) = delete;
+
+    /* the events deferred by each state */
+    static constexpr const DeferTable<TMachineType> deferTable_ = DeferTable<TMachineType>::make();
+
+    /* returns the events deferred by the current state */
+    const TEventMask& deferred() const
+    {
+        const TStateNum& state = process_.state();
+        return deferTable_.masks[state.valid() ? state.get() : TMachineType::stateCount];
+    }
+
+    /* gives the process the kept events the new state accepts, in order, until it accepts none of them, and drops the
+     ones it does not defer either */
+    void replay()
+    {
+        for (size_t i = 0; i < count_;)
+        {
+            const size_t event = events_[i].get();
+            const bool accepted = TMachineType::accepted(process_.state()).test(event);
+            if (!accepted && deferred().test(event))
+            {
+                ++i;
+                continue;
+            }
+            const TEventNum next = events_[i];
+            for (size_t j = i + 1; j < count_; ++j)
+                events_[j - 1] = events_[j];
+            --count_;
+            if (accepted && process_.next(next))
+                i = 0;
+        }
+    }
+
+public:
+    /* sets the process to no-state and drops the events kept */
+    void reset()
+    {
+        count_ = 0;
+        process_.reset();
+    }
+
+    /* sets the process to its begin state and drops the events kept */
+    void start()
+    {
+        count_ = 0;
+        process_.start();
+    }
+
+    /* processes the event given: follows its link and then gives the process the kept events the new state accepts, or
+     keeps it if the state defers it.  returns false if it was neither */
+    bool next(const TEventNum& event)
+    {
+        if (process_.next(event))
+        {
+            replay();
+            return true;
+        }
+        if (!process_.state().valid() || count_ == TCapacity || !deferred().test(event.get()))
+            return false;
+        events_[count_++] = event;
+        return true;
+    }
+
+    /* processes the event TEvent as next */
+    template<typename TEvent>
+    typename std::enable_if<TypeListContains<typename TMachineType::TEventTypes, TEvent>::value, bool>::type next()
+    {
+        TEventNum event{};
+        event.template set<TEvent>();
+        return next(event);
+    }
+
+    /* returns the number of events kept */
+    size_t pending() const { return count_; }
+
+    /* returns the process */
+    TProcess& process() { return process_; }
+    /* returns the process */
+    const TProcess& process() const { return process_; }
+
+private:
+    /* the process */
+    TProcess process_;
+    /* the events kept, in the order they came in */
+    TEventNum events_[TCapacity];
+    /* the number of events kept */
+    size_t count_;
+};
+
+/* definition of the defer table */
+template<typename TProcess, size_t TCapacity>
+constexpr const DeferTable<typename DeferringProcess<TProcess, TCapacity>::TMachineType>
+    DeferringProcess<TProcess, TCapacity>::deferTable_;
+
+} // namespace states
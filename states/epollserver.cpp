@@ -0,0 +1,114 @@
+//
+//  epollserver.cpp
+//  states
+//
+//  Created by Daniel Pav on 10/19/26.
+//  Copyright © 2026 Daniel Pav. All rights reserved.
+//
+
+#include "epollserver.hpp"
+
+#if defined(__linux__)
+
+#include <arpa/inet.h>
+#include <cerrno>
+#include <netinet/in.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace states
+{
+bool EpollSockets::listen(const char* address, uint16_t port, int backlog)
+{
+    close();
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    if (::inet_pton(AF_INET, address, &addr.sin_addr) != 1)
+        return false;
+    epoll_ = ::epoll_create1(EPOLL_CLOEXEC);
+    listen_ = ::socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (epoll_ < 0 || listen_ < 0)
+    {
+        close();
+        return false;
+    }
+    const int on = 1;
+    ::setsockopt(listen_, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+    socklen_t size = sizeof(addr);
+    if (::bind(listen_, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) != 0 ||
+        ::listen(listen_, backlog) != 0 || ::getsockname(listen_, reinterpret_cast<sockaddr*>(&addr), &size) != 0)
+    {
+        close();
+        return false;
+    }
+    port_ = ntohs(addr.sin_port);
+    epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.u64 = 0;
+    if (::epoll_ctl(epoll_, EPOLL_CTL_ADD, listen_, &event) != 0)
+    {
+        close();
+        return false;
+    }
+    return true;
+}
+
+int EpollSockets::accept()
+{
+    return (listen_ < 0) ? -1 : ::accept4(listen_, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+}
+
+bool EpollSockets::add(int fd, uint64_t value)
+{
+    epoll_event event{};
+    event.events = EPOLLIN | EPOLLRDHUP;
+    event.data.u64 = value;
+    return ::epoll_ctl(epoll_, EPOLL_CTL_ADD, fd, &event) == 0;
+}
+
+void EpollSockets::remove(int fd)
+{
+    ::epoll_ctl(epoll_, EPOLL_CTL_DEL, fd, nullptr);
+    ::close(fd);
+}
+
+int EpollSockets::wait(uint64_t* ready, int timeout)
+{
+    if (epoll_ < 0)
+        return -1;
+    epoll_event events[maxReady];
+    int n;
+    do
+        n = ::epoll_wait(epoll_, events, static_cast<int>(maxReady), timeout);
+    while (n < 0 && errno == EINTR);
+    for (int i = 0; i < n; ++i)
+        ready[i] = events[i].data.u64;
+    return n;
+}
+
+long EpollSockets::read(int fd, char* buffer, size_t size)
+{
+    ssize_t n;
+    do
+        n = ::read(fd, buffer, size);
+    while (n < 0 && errno == EINTR);
+    if (n >= 0)
+        return static_cast<long>(n);
+    return (errno == EAGAIN || errno == EWOULDBLOCK) ? -1 : -2;
+}
+
+void EpollSockets::close()
+{
+    if (listen_ >= 0)
+        ::close(listen_);
+    if (epoll_ >= 0)
+        ::close(epoll_);
+    listen_ = -1;
+    epoll_ = -1;
+    port_ = 0;
+}
+} // namespace states
+
+#endif
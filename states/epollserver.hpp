@@ -0,0 +1,298 @@
+//
+//  epollserver.hpp
+//  states
+//
+//  Created by Daniel Pav on 10/19/26.
+//  Copyright © 2026 Daniel Pav. All rights reserved.
+//
+
+#pragma once
+
+#if defined(__linux__)
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+namespace states
+{
+/* the sockets and the epoll instance of an EpollServer.  linux only */
+class EpollSockets
+{
+public:
+    /* most sockets reported by one wait */
+    static const constexpr size_t maxReady = 64;
+
+    EpollSockets() = default;
+    ~EpollSockets() { close(); }
+    EpollSockets(const EpollSockets&) = delete;
+    EpollSockets& operator=(const EpollSockets&) = delete;
+
+public:
+    /* creates the epoll instance and a non-blocking socket listening on the address and port, added with the value 0.
+     port 0 picks a free port.  returns false on failure */
+    bool listen(const char* address, uint16_t port, int backlog);
+    /* returns the port listened on */
+    uint16_t port() const { return port_; }
+    /* accepts a connection as a non-blocking socket, returns -1 if there is none */
+    int accept();
+    /* adds the socket to be read with the value, returns false on failure */
+    bool add(int fd, uint64_t value);
+    /* removes and closes the socket */
+    void remove(int fd);
+    /* waits up to timeout milliseconds (-1 for ever) for ready sockets, setting the values they were added with.
+     returns their number, -1 on failure */
+    int wait(uint64_t* ready, int timeout);
+    /* reads into the buffer without blocking.  returns the bytes read, 0 at the end and -1 if there is nothing to read
+     yet, -2 on failure */
+    static long read(int fd, char* buffer, size_t size);
+    /* closes the listening socket and the epoll instance */
+    void close();
+
+private:
+    int epoll_{-1};
+    int listen_{-1};
+    uint16_t port_{0};
+};
+
+/* serves connections with one process of type TProcess for each, driven by what is read from the connection.  the loop
+ does not block: poll waits for ready connections and reads each once into its own buffer of TBufferSize bytes.  the
+ handler (THandler) turns the bytes into events where they lie, without copying them, and the events of a read are
+ collected and then given to the process together, at most TBatch at a time.  the handler has:
+    void open(TData& data, int fd): a connection was accepted, before the process is started.
+    bool classify(TData& data, const char*& in, const char* end, TEventNum& event): sets the event of the next message
+        in [in, end) and advances in past it, or returns false if the message is not complete yet.  bytes not used
+        are kept for the next read.
+    void message(TData& data, const char* begin, const char* end): the bytes of the message of the event that is
+        about to be given to the process, still in the buffer, for its ops to use.
+    void close(TData& data): the connection is about to be closed.
+ a connection is closed when the peer closes it, when its process is done or when its buffer is full of an incomplete
+ message.  events the process rejects are counted and dropped.  the connections, with their data and processes, are
+ reused once closed.  linux only.
+ */
+template<typename TProcess, typename THandler, size_t TBufferSize = 16384, size_t TBatch = 64>
+class EpollServer
+{
+public:
+    /* the data of the processes */
+    using TData = typename TProcess::TDataType;
+    /* the event num type of the processes */
+    using TEventNum = typename TProcess::TEventNum;
+
+    /* counts of what the server did */
+    struct Stats
+    {
+        uint64_t accepted{0};
+        uint64_t closed{0};
+        uint64_t events{0};
+        uint64_t rejected{0};
+    };
+
+private:
+    /* a connection: its socket, its process with the data and the bytes read but not used yet */
+    struct Connection
+    {
+        Connection() : data(), process(data) {}
+
+        TData data;
+        TProcess process;
+        int fd{-1};
+        size_t used{0};
+        size_t next{0};
+        char buffer[TBufferSize];
+    };
+
+    /* no connection */
+    static const constexpr size_t none = ~size_t(0);
+
+public:
+    /* creates a server for at most maxConnections connections at once */
+    EpollServer(const THandler& handler = THandler(), size_t maxConnections = 1024) :
+        handler_(handler), maxConnections_(maxConnections)
+    {
+    }
+    /* closes every connection */
+    ~EpollServer() { close(); }
+
+private:
+    EpollServer(const EpollServer&) = delete;
+    EpollServer& operator=(const EpollServer&) = delete;
+
+    /* takes a free connection, creating one if none has been closed yet.  none if there are too many */
+    size_t take()
+    {
+        if (free_ != none)
+        {
+            const size_t index = free_;
+            free_ = connections_[index]->next;
+            return index;
+        }
+        if (connections_.size() >= maxConnections_)
+            return none;
+        connections_.emplace_back(new Connection());
+        return connections_.size() - 1;
+    }
+
+    /* accepts every waiting connection */
+    void acceptAll()
+    {
+        int fd;
+        while ((fd = sockets_.accept()) >= 0)
+        {
+            const size_t index = take();
+            if (index == none || !sockets_.add(fd, index + 1))
+            {
+                sockets_.remove(fd);
+                if (index != none)
+                    give(index);
+                continue;
+            }
+            Connection& connection = *connections_[index];
+            connection.fd = fd;
+            connection.used = 0;
+            connection.process.reset();
+            handler_.open(connection.data, fd);
+            connection.process.start();
+            ++open_;
+            ++stats_.accepted;
+        }
+    }
+
+    /* puts the connection on the free list */
+    void give(size_t index)
+    {
+        connections_[index]->next = free_;
+        free_ = index;
+    }
+
+    /* closes the connection and gives it back */
+    void drop(size_t index)
+    {
+        Connection& connection = *connections_[index];
+        handler_.close(connection.data);
+        sockets_.remove(connection.fd);
+        connection.fd = -1;
+        give(index);
+        --open_;
+        ++stats_.closed;
+    }
+
+    /* passes a batch of events to the process, each after its message, returns false once it is done */
+    bool dispatch(Connection& connection, const TEventNum* events, const char* const* messages, size_t n)
+    {
+        for (size_t i = 0; i < n; ++i)
+        {
+            ++stats_.events;
+            handler_.message(connection.data, messages[i], messages[i + 1]);
+            if (!connection.process.next(events[i]))
+                ++stats_.rejected;
+            if (connection.process.done())
+                return false;
+        }
+        return true;
+    }
+
+    /* reads the connection once and handles what was read, returns false if it is to be closed */
+    bool serve(Connection& connection)
+    {
+        const long n = EpollSockets::read(connection.fd, connection.buffer + connection.used,
+                                          TBufferSize - connection.used);
+        if (n == -1)
+            return true;
+        if (n <= 0)
+            return false;
+        const char* in = connection.buffer;
+        const char* end = connection.buffer + connection.used + n;
+        TEventNum events[TBatch];
+        const char* messages[TBatch + 1] = {in};
+        size_t count = 0;
+        while (in != end && handler_.classify(connection.data, in, end, events[count]))
+        {
+            messages[++count] = in;
+            if (count == TBatch)
+            {
+                if (!dispatch(connection, events, messages, count))
+                    return false;
+                messages[0] = in;
+                count = 0;
+            }
+        }
+        if (count && !dispatch(connection, events, messages, count))
+            return false;
+        connection.used = static_cast<size_t>(end - in);
+        if (connection.used == TBufferSize)
+            return false;
+        if (connection.used && in != connection.buffer)
+            std::memmove(connection.buffer, in, connection.used);
+        return true;
+    }
+
+public:
+    /* listens on the address and port, port 0 picks a free port.  returns false on failure */
+    bool listen(const char* address, uint16_t port, int backlog = 128)
+    {
+        return sockets_.listen(address, port, backlog);
+    }
+
+    /* returns the port listened on */
+    uint16_t port() const { return sockets_.port(); }
+
+    /* waits up to timeout milliseconds for connections or data and handles them.  returns the number of sockets that
+     were ready, -1 on failure */
+    int poll(int timeout)
+    {
+        uint64_t ready[EpollSockets::maxReady];
+        const int n = sockets_.wait(ready, timeout);
+        for (int i = 0; i < n; ++i)
+        {
+            if (ready[i] == 0)
+            {
+                acceptAll();
+                continue;
+            }
+            const size_t index = static_cast<size_t>(ready[i] - 1);
+            if (connections_[index]->fd < 0)
+                continue;
+            if (!serve(*connections_[index]))
+                drop(index);
+        }
+        return n;
+    }
+
+    /* closes every connection and stops listening */
+    void close()
+    {
+        for (size_t i = 0; i < connections_.size(); ++i)
+            if (connections_[i]->fd >= 0)
+                drop(i);
+        sockets_.close();
+    }
+
+    /* returns the number of open connections */
+    size_t connections() const { return open_; }
+
+    /* returns the counts */
+    const Stats& stats() const { return stats_; }
+
+private:
+    /* the sockets */
+    EpollSockets sockets_;
+    /* turns bytes into events */
+    THandler handler_;
+    /* most connections at once */
+    size_t maxConnections_;
+    /* every connection ever opened, the closed ones are reused */
+    std::vector<std::unique_ptr<Connection>> connections_;
+    /* first closed connection */
+    size_t free_{none};
+    /* open connections */
+    size_t open_{0};
+    /* counts */
+    Stats stats_;
+};
+
+} // namespace states
+
+#endif
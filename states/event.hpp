@@ -23,7 +23,7 @@ private:
 
 public:
     /* returns the name */
-    static const char* name() { return TNameImpl::name(); }
+    static constexpr const char* name() { return TNameImpl::name(); }
 
     /* visit the event by using its name */
     template<typename TVisitor>
@@ -0,0 +1,167 @@
+//
+//  eventlog.cpp
+//  states
+//
+//  Created by Daniel Pav on 10/19/26.
+//  Copyright © 2026 Daniel Pav. All rights reserved.
+//
+
+#include "eventlog.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace states
+{
+namespace
+{
+/* marks the start of a segment */
+const char segmentMagic[8] = {'S', 'T', 'A', 'T', 'E', 'L', 'O', 'G'};
+/* magic then tag, padded */
+const size_t segmentHeader = 16;
+
+std::string segmentName(const std::string& prefix, uint64_t segment)
+{
+    char suffix[32];
+    std::snprintf(suffix, sizeof(suffix), ".%08llu", static_cast<unsigned long long>(segment));
+    return prefix + suffix;
+}
+} // namespace
+
+bool SegmentWriter::open(const std::string& prefix, size_t segmentSize, uint32_t tag)
+{
+    close();
+    if (segmentSize <= segmentHeader)
+        return false;
+    /* a shorter log must not be followed by the segments of the one it replaces */
+    for (uint64_t n = 0; ::unlink(segmentName(prefix, n).c_str()) == 0; ++n)
+    {
+    }
+    return start(prefix, segmentSize, tag, 0);
+}
+
+bool SegmentWriter::resume(const std::string& prefix, size_t segmentSize, uint32_t tag)
+{
+    close();
+    if (segmentSize <= segmentHeader)
+        return false;
+    uint64_t n = 0;
+    for (SegmentReader segment; segment.open(prefix, n); ++n)
+        if (segment.tag() != tag)
+            return false;
+    return start(prefix, segmentSize, tag, n);
+}
+
+bool SegmentWriter::start(const std::string& prefix, size_t segmentSize, uint32_t tag, uint64_t first)
+{
+    prefix_ = prefix;
+    size_ = segmentSize;
+    tag_ = tag;
+    segment_ = first;
+    next_ = first;
+    return roll(0) != nullptr;
+}
+
+uint8_t* SegmentWriter::roll(size_t n)
+{
+    if (size_ == 0 || n > size_ - segmentHeader)
+        return nullptr;
+    close();
+    const std::string name = segmentName(prefix_, next_);
+    fd_ = ::open(name.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd_ < 0)
+        return nullptr;
+    void* map = MAP_FAILED;
+    if (::ftruncate(fd_, static_cast<off_t>(size_)) == 0)
+        map = ::mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+    if (map == MAP_FAILED)
+    {
+        ::close(fd_);
+        fd_ = -1;
+        return nullptr;
+    }
+    base_ = static_cast<uint8_t*>(map);
+    std::memcpy(base_, segmentMagic, sizeof(segmentMagic));
+    std::memcpy(base_ + sizeof(segmentMagic), &tag_, sizeof(tag_));
+    used_ = segmentHeader;
+    synced_ = 0;
+    segment_ = next_++;
+    return base_ + used_;
+}
+
+bool SegmentWriter::sync()
+{
+    if (!base_ || synced_ == used_)
+        return true;
+    const size_t page = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+    const size_t from = synced_ - (synced_ % page);
+    if (::msync(base_ + from, used_ - from, MS_SYNC) != 0)
+        return false;
+    synced_ = used_;
+    return true;
+}
+
+void SegmentWriter::unmap()
+{
+    if (base_)
+        ::munmap(base_, size_);
+    base_ = nullptr;
+    if (fd_ >= 0)
+        ::close(fd_);
+    fd_ = -1;
+    /* nothing left to reserve until the next segment */
+    used_ = size_;
+    synced_ = size_;
+}
+
+void SegmentWriter::close()
+{
+    sync();
+    unmap();
+}
+
+bool SegmentReader::open(const std::string& prefix, uint64_t segment)
+{
+    close();
+    const std::string name = segmentName(prefix, segment);
+    const int fd = ::open(name.c_str(), O_RDONLY);
+    if (fd < 0)
+        return false;
+    struct stat st;
+    void* map = MAP_FAILED;
+    if (::fstat(fd, &st) == 0 && static_cast<size_t>(st.st_size) >= segmentHeader)
+        map = ::mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (map == MAP_FAILED)
+        return false;
+    map_ = map;
+    size_ = static_cast<size_t>(st.st_size);
+    ::madvise(map_, size_, MADV_SEQUENTIAL);
+    const uint8_t* base = static_cast<const uint8_t*>(map_);
+    if (std::memcmp(base, segmentMagic, sizeof(segmentMagic)) != 0)
+    {
+        close();
+        return false;
+    }
+    std::memcpy(&tag_, base + sizeof(segmentMagic), sizeof(tag_));
+    begin_ = base + segmentHeader;
+    end_ = base + size_;
+    return true;
+}
+
+void SegmentReader::close()
+{
+    if (map_)
+        ::munmap(map_, size_);
+    map_ = nullptr;
+    begin_ = nullptr;
+    end_ = nullptr;
+    size_ = 0;
+    tag_ = 0;
+}
+
+} // namespace states
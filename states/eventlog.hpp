@@ -0,0 +1,357 @@
+//
+//  eventlog.hpp
+//  states
+//
+//  Created by Daniel Pav on 10/19/26.
+//  Copyright © 2026 Daniel Pav. All rights reserved.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+
+#include "invoker.hpp"
+#include "typelist.hpp"
+
+namespace states
+{
+/* little endian base 128 integers.  a value takes one byte per 7 bits, at most 10 bytes */
+struct VarInt
+{
+    /* most bytes taken by a value */
+    static const constexpr size_t maxSize = 10;
+
+    /* writes the value to out, returns the number of bytes written */
+    static size_t put(uint8_t* out, uint64_t value)
+    {
+        size_t n = 0;
+        while (value >= 0x80)
+        {
+            out[n++] = static_cast<uint8_t>(value | 0x80);
+            value >>= 7;
+        }
+        out[n++] = static_cast<uint8_t>(value);
+        return n;
+    }
+
+    /* reads a value from in, advancing it.  returns false if the value runs past end or is not in its shortest form
+     (which is how a value cut short by a crash shows up) */
+    static bool get(const uint8_t*& in, const uint8_t* end, uint64_t& value)
+    {
+        value = 0;
+        for (unsigned shift = 0; in != end && shift < 64; shift += 7)
+        {
+            const uint8_t byte = *in++;
+            value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+            if ((byte & 0x80) == 0)
+                return byte != 0 || shift == 0;
+        }
+        return false;
+    }
+
+    /* maps signed values to unsigned so that small magnitudes stay small */
+    static uint64_t zigzag(int64_t value)
+    {
+        return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+    }
+
+    /* inverse of zigzag */
+    static int64_t unzigzag(uint64_t value)
+    {
+        return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+    }
+};
+
+/* writes memory mapped segment files of a fixed size, named prefix.00000000, prefix.00000001, ... each segment starts
+ with a header holding a tag given by the user of the segments.  unused space at the end of a segment is zero.  posix
+ only */
+class SegmentWriter
+{
+public:
+    SegmentWriter() = default;
+    ~SegmentWriter() { close(); }
+    SegmentWriter(const SegmentWriter&) = delete;
+    SegmentWriter& operator=(const SegmentWriter&) = delete;
+
+public:
+    /* starts writing segments from the first one, removing every segment that exists.  returns false on failure */
+    bool open(const std::string& prefix, size_t segmentSize, uint32_t tag);
+    /* starts writing segments after the last one that exists, leaving those as they are.  returns false if one of them
+     has a different tag, or on failure */
+    bool resume(const std::string& prefix, size_t segmentSize, uint32_t tag);
+    /* returns space for n bytes, starting a new segment if the current one is too full.  nullptr on failure */
+    uint8_t* reserve(size_t n) { return (size_ - used_ >= n) ? base_ + used_ : roll(n); }
+    /* marks n bytes of the space returned by reserve as written */
+    void commit(size_t n) { used_ += n; }
+    /* flushes what was written since the last sync to the disk, returns false on failure */
+    bool sync();
+    /* syncs and unmaps the current segment */
+    void close();
+    /* returns the number of the current segment, this changes when reserve starts a new one */
+    uint64_t segment() const { return segment_; }
+
+private:
+    /* sets the prefix, size and tag and maps the segment first */
+    bool start(const std::string& prefix, size_t segmentSize, uint32_t tag, uint64_t first);
+    /* maps the next segment */
+    uint8_t* roll(size_t n);
+    /* unmaps the current segment */
+    void unmap();
+
+private:
+    std::string prefix_;
+    size_t size_{0};
+    size_t used_{0};
+    size_t synced_{0};
+    uint32_t tag_{0};
+    uint64_t segment_{0};
+    uint64_t next_{0};
+    uint8_t* base_{nullptr};
+    int fd_{-1};
+};
+
+/* reads a segment written by SegmentWriter by mapping it.  posix only */
+class SegmentReader
+{
+public:
+    SegmentReader() = default;
+    ~SegmentReader() { close(); }
+    SegmentReader(const SegmentReader&) = delete;
+    SegmentReader& operator=(const SegmentReader&) = delete;
+
+public:
+    /* maps the segment with the given number, returns false if it does not exist or is not a segment */
+    bool open(const std::string& prefix, uint64_t segment);
+    /* unmaps the segment */
+    void close();
+    /* returns the tag given to the writer */
+    uint32_t tag() const { return tag_; }
+    /* returns the first byte after the header */
+    const uint8_t* begin() const { return begin_; }
+    /* returns the end of the segment */
+    const uint8_t* end() const { return end_; }
+
+private:
+    const uint8_t* begin_{nullptr};
+    const uint8_t* end_{nullptr};
+    void* map_{nullptr};
+    size_t size_{0};
+    uint32_t tag_{0};
+};
+
+/* helpers for packing an event log record: the zigzag delta of the process id from the previous record of the segment
+ above the event index plus one, as one varint.  the event field is never 0 so the first byte of a record is never 0.
+ an event field of 0 marks a record whose id is too far from the previous one: it is followed by the id and the event
+ as two more varints */
+template<typename TMachine>
+struct EventLogFormat
+{
+    /* number of events */
+    static const constexpr size_t events = TypeListSize<typename TMachine::TEventTypes>::size;
+
+    /* bits needed for 0 (reserved) and every event index plus one */
+    static constexpr unsigned bitsFor(size_t n) { return (n == 0) ? 0 : 1 + bitsFor(n >> 1); }
+    static const constexpr unsigned eventBits = bitsFor(events);
+    static const constexpr uint64_t eventMask = (uint64_t(1) << eventBits) - 1;
+
+    /* tag of the segments, the format version and the number of events */
+    static const constexpr uint32_t tag = 0x01000000u | static_cast<uint32_t>(events);
+
+    /* largest record */
+    static const constexpr size_t maxRecord = 3 * VarInt::maxSize;
+};
+
+/* appends the events accepted by processes to a log of segments so that the processes can be brought back after a
+ crash with EventLogReplayer.  each record is the id of the process and the event, compressed to usually one or two
+ bytes.  segments are files of a fixed size written through a mapping, so appending does not make system calls except
+ to start a segment.  if syncEvery is not 0, the log is flushed to the disk after every syncEvery records, otherwise
+ only when sync is called or the writer is closed.  open starts a new log, removing the segments of the one before.  to
+ keep logging after a crash, replay the log and then resume it, which appends in new segments after the old ones.
+ */
+template<typename TMachine>
+class EventLogWriter
+{
+public:
+    /* the event num type of the machine */
+    using TEventNum = typename TMachine::TEventNum;
+
+private:
+    using TFormat = EventLogFormat<TMachine>;
+
+public:
+    /* starts a new log with the prefix, removing the log there, returns false on failure */
+    bool open(const std::string& prefix, size_t segmentSize = size_t(64) << 20, size_t syncEvery = 0)
+    {
+        syncEvery_ = syncEvery;
+        unsynced_ = 0;
+        last_ = 0;
+        return segments_.open(prefix, segmentSize, TFormat::tag);
+    }
+
+    /* appends to the log with the prefix, starting a new segment after its last one, or starts a new log if there is
+     none.  returns false if the log was written for a different machine, or on failure */
+    bool resume(const std::string& prefix, size_t segmentSize = size_t(64) << 20, size_t syncEvery = 0)
+    {
+        syncEvery_ = syncEvery;
+        unsynced_ = 0;
+        last_ = 0;
+        return segments_.resume(prefix, segmentSize, TFormat::tag);
+    }
+
+    /* appends a record, returns false if the event is invalid or the log cannot be written */
+    bool append(uint64_t id, const TEventNum& event)
+    {
+        if (!event.valid())
+            return false;
+        const uint64_t segment = segments_.segment();
+        uint8_t* out = segments_.reserve(TFormat::maxRecord);
+        if (!out)
+            return false;
+        if (segments_.segment() != segment)
+            last_ = 0;
+        const uint64_t delta = VarInt::zigzag(static_cast<int64_t>(id - last_));
+        const uint64_t field = event.get() + 1;
+        size_t n;
+        if ((delta >> (64 - TFormat::eventBits)) == 0)
+            n = VarInt::put(out, (delta << TFormat::eventBits) | field);
+        else
+        {
+            n = VarInt::put(out, uint64_t(1) << TFormat::eventBits);
+            n += VarInt::put(out + n, id);
+            n += VarInt::put(out + n, field);
+        }
+        segments_.commit(n);
+        last_ = id;
+        if (syncEvery_ && ++unsynced_ >= syncEvery_)
+            return sync();
+        return true;
+    }
+
+    /* appends a record of the event TEvent */
+    template<typename TEvent>
+    bool append(uint64_t id)
+    {
+        TEventNum event;
+        event.template set<TEvent>();
+        return append(id, event);
+    }
+
+    /* flushes the log to the disk, returns false on failure */
+    bool sync()
+    {
+        unsynced_ = 0;
+        return segments_.sync();
+    }
+
+    /* syncs and closes the log */
+    void close() { segments_.close(); }
+
+private:
+    /* the segment files */
+    SegmentWriter segments_;
+    /* id of the previous record in the segment */
+    uint64_t last_{0};
+    /* records between syncs, 0 for no automatic sync */
+    size_t syncEvery_{0};
+    /* records since the last sync */
+    size_t unsynced_{0};
+};
+
+/* the result of a replay */
+struct ReplayCount
+{
+    /* records read from the log */
+    uint64_t records{0};
+    /* records whose process was found and accepted the event */
+    uint64_t accepted{0};
+};
+
+/* replays a log written by EventLogWriter.  the segments are mapped and read in order, and each record is given to the
+ process returned by lookup(id), which returns a pointer to the process or nullptr to skip the record.  the process is
+ driven with next(TEventNum), or with the SkipInvoker when the ops are not wanted.  replay stops at the first segment that
+ is missing or was written for a different machine, and at the end of the records of each segment.
+ */
+template<typename TMachine>
+class EventLogReplayer
+{
+public:
+    /* the event num type of the machine */
+    using TEventNum = typename TMachine::TEventNum;
+
+private:
+    using TFormat = EventLogFormat<TMachine>;
+
+public:
+    EventLogReplayer(const std::string& prefix) : prefix_(prefix) {}
+
+public:
+    /* replays every record, running the ops if ops is true */
+    template<typename TLookup>
+    ReplayCount replay(TLookup lookup, bool ops = true) const
+    {
+        ReplayCount count;
+        SegmentReader segment;
+        for (uint64_t n = 0; segment.open(prefix_, n) && segment.tag() == TFormat::tag; ++n)
+        {
+            if (ops)
+                replaySegment(segment, lookup, count, std::true_type());
+            else
+                replaySegment(segment, lookup, count, std::false_type());
+        }
+        return count;
+    }
+
+private:
+    /* delivers the event running the ops */
+    template<typename TProcess>
+    static bool deliver(TProcess& process, const TEventNum& event, std::true_type)
+    {
+        return process.next(event);
+    }
+
+    /* delivers the event without running the ops */
+    template<typename TProcess>
+    static bool deliver(TProcess& process, const TEventNum& event, std::false_type)
+    {
+        SkipInvoker invoker;
+        return process.next(event, invoker);
+    }
+
+    /* replays the records of one segment */
+    template<typename TLookup, typename TOps>
+    static void replaySegment(const SegmentReader& segment, TLookup& lookup, ReplayCount& count, TOps ops)
+    {
+        const uint8_t* in = segment.begin();
+        const uint8_t* end = segment.end();
+        uint64_t last = 0;
+        TEventNum event;
+        while (in != end && *in != 0)
+        {
+            uint64_t value;
+            if (!VarInt::get(in, end, value))
+                return;
+            uint64_t id;
+            uint64_t field = value & TFormat::eventMask;
+            if (field != 0)
+                id = last + static_cast<uint64_t>(VarInt::unzigzag(value >> TFormat::eventBits));
+            else if (!VarInt::get(in, end, id) || !VarInt::get(in, end, field))
+                return;
+            if (field == 0 || !event.set(static_cast<size_t>(field - 1)) || !event.valid())
+                return;
+            last = id;
+            ++count.records;
+            auto process = lookup(id);
+            if (process && deliver(*process, event, ops))
+                ++count.accepted;
+        }
+    }
+
+private:
+    /* prefix of the segment files */
+    std::string prefix_;
+};
+
+} // namespace states
@@ -0,0 +1,200 @@
+//
+//  flightrecorder.hpp
+//  states
+//
+//  Created by Daniel Pav on 10/19/26.
+//  Copyright © 2026 Daniel Pav. All rights reserved.
+//
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+
+#include "cycles.hpp"
+#include "named.hpp"
+#include "typelist.hpp"
+
+namespace states
+{
+/* an observer for a process that keeps the last N transitions of that process in a fixed size ring.  each transition
+ is stored as a tick count and a single packed integer holding the from state, the event and the to state.  starts are
+ stored with no from state and no event, resets with no event and no to state.  recording does not allocate or lock
+ and is meant to be left on.  the process owning the recorder is the only writer.  snapshot may be called from any
+ other thread and returns only entries that were not being overwritten while they were copied.  N must be a power of
+ two.
+ */
+template<typename TMachine, size_t N = 64>
+class FlightRecorder
+{
+public:
+    /* to indicate "no state" or "no event" in a record */
+    static const constexpr size_t npos = TypeListIndexBase::npos;
+    /* number of records kept */
+    static const constexpr size_t capacity = N;
+
+    /* a decoded record */
+    struct Record
+    {
+        /* tick count at which the transition completed */
+        uint64_t ticks;
+        /* index of the from state, npos for a start */
+        size_t from;
+        /* index of the event, npos for a start or reset */
+        size_t event;
+        /* index of the to state, npos for a reset */
+        size_t to;
+    };
+
+private:
+    static_assert(N != 0 && (N & (N - 1)) == 0, "capacity of a flight recorder must be a power of two");
+    static_assert(TypeListSize<typename TMachine::TStateTypes>::size < 0xffff, "too many states to pack");
+    static_assert(TypeListSize<typename TMachine::TEventTypes>::size < 0xffff, "too many events to pack");
+
+    /* width and mask of each packed field */
+    static const constexpr unsigned bits = 16;
+    static const constexpr uint64_t mask = 0xffff;
+
+    /* one entry of the ring.  seq is odd while the entry is written and 2 * (n + 1) once the n-th record is in it */
+    struct Slot
+    {
+        std::atomic<uint64_t> seq{0};
+        std::atomic<uint64_t> ticks{0};
+        std::atomic<uint64_t> packed{0};
+    };
+
+public:
+    FlightRecorder() = default;
+    /* copying an observer gives a new, empty ring */
+    FlightRecorder(const FlightRecorder&) {}
+    FlightRecorder& operator=(const FlightRecorder&) = delete;
+
+public:
+    /* packs the from, event and to indices into one integer */
+    static uint64_t pack(size_t from, size_t event, size_t to)
+    {
+        return packField(from) | (packField(event) << bits) | (packField(to) << (2 * bits));
+    }
+
+    /* unpacks the from, event and to indices of an integer made by pack */
+    static void unpack(uint64_t packed, size_t& from, size_t& event, size_t& to)
+    {
+        from = unpackField(packed);
+        event = unpackField(packed >> bits);
+        to = unpackField(packed >> (2 * bits));
+    }
+
+    /* returns the name of the state at index, nullptr for npos */
+    static const char* stateName(size_t index) { return NamedAt<typename TMachine::TStateTypes>::name(index); }
+
+    /* returns the name of the event at index, nullptr for npos */
+    static const char* eventName(size_t index) { return NamedAt<typename TMachine::TEventTypes>::name(index); }
+
+public:
+    /* records the start of the process */
+    template<typename TStateNum>
+    void onStart(const TStateNum& state)
+    {
+        record(npos, npos, state.get());
+    }
+
+    /* records a transition of the process */
+    template<typename TStateNum, typename TEventNum>
+    void onTransition(const TStateNum& from, const TEventNum& event, const TStateNum& to)
+    {
+        record(from.get(), event.get(), to.get());
+    }
+
+    /* records a reset of the process */
+    template<typename TStateNum>
+    void onReset(const TStateNum& from)
+    {
+        record(from.get(), npos, npos);
+    }
+
+public:
+    /* returns the number of records ever written */
+    uint64_t count() const { return head_.load(std::memory_order_acquire); }
+
+    /* copies up to max of the most recent records into out, oldest first, returns the number copied.  safe to call from
+     a thread other than the one driving the process */
+    size_t snapshot(Record* out, size_t max) const
+    {
+        const uint64_t head = head_.load(std::memory_order_acquire);
+        const uint64_t kept = (head < N) ? head : N;
+        const uint64_t wanted = (kept < max) ? kept : max;
+        size_t copied = 0;
+        for (uint64_t n = head - wanted; n != head; ++n)
+        {
+            const Slot& slot = slots_[n & (N - 1)];
+            const uint64_t before = slot.seq.load(std::memory_order_acquire);
+            const uint64_t ticks = slot.ticks.load(std::memory_order_relaxed);
+            const uint64_t packed = slot.packed.load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            const uint64_t after = slot.seq.load(std::memory_order_relaxed);
+            if (before != after || before != 2 * (n + 1))
+                continue;
+            Record& r = out[copied++];
+            r.ticks = ticks;
+            unpack(packed, r.from, r.event, r.to);
+        }
+        return copied;
+    }
+
+    /* writes the records to the stream, oldest first, one per line with the state and event names */
+    void dump(std::ostream& os) const
+    {
+        Record records[N];
+        const size_t n = snapshot(records, N);
+        for (size_t i = 0; i < n; ++i)
+        {
+            const Record& r = records[i];
+            os << r.ticks << ": " << nameOr(stateName(r.from), "[*]") << " -> " << nameOr(stateName(r.to), "[*]");
+            if (r.event != npos)
+                os << " : " << eventName(r.event);
+            os << std::endl;
+        }
+    }
+
+private:
+    static uint64_t packField(size_t index) { return (index == npos) ? mask : (static_cast<uint64_t>(index) & mask); }
+
+    static size_t unpackField(uint64_t field)
+    {
+        field &= mask;
+        return (field == mask) ? npos : static_cast<size_t>(field);
+    }
+
+    static const char* nameOr(const char* name, const char* other) { return name ? name : other; }
+
+    /* writes the next slot.  single writer, so the head is only read and written by this thread */
+    void record(size_t from, size_t event, size_t to)
+    {
+        const uint64_t n = head_.load(std::memory_order_relaxed);
+        Slot& slot = slots_[n & (N - 1)];
+        slot.seq.store(2 * n + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        slot.ticks.store(Cycles::now(), std::memory_order_relaxed);
+        slot.packed.store(pack(from, event, to), std::memory_order_relaxed);
+        slot.seq.store(2 * (n + 1), std::memory_order_release);
+        head_.store(n + 1, std::memory_order_release);
+    }
+
+private:
+    /* the ring of records */
+    Slot slots_[N];
+    /* number of records ever written, the next record goes to slots_[head_ % N] */
+    std::atomic<uint64_t> head_{0};
+};
+
+/* dumps the records (for debugging) */
+template<typename TMachine, size_t N>
+std::ostream& operator<<(std::ostream& os, const FlightRecorder<TMachine, N>& obj)
+{
+    obj.dump(os);
+    return os;
+}
+
+} // namespace states
@@ -0,0 +1,35 @@
+//
+//  invoker.hpp
+//  states
+//
+//  Created by Daniel Pav on 10/19/26.
+//  Copyright © 2026 Daniel Pav. All rights reserved.
+//
+
+#pragma once
+
+namespace states
+{
+/* provides the default way to run an operation: construct it and call it on the data.  an invoker is given the type
+ that owns the operation (the link or the state) so that other invokers can account for each owner separately */
+struct DirectInvoker
+{
+    /* runs the operation TOp of TOwner on the data */
+    template<typename TOwner, typename TOp, typename TData>
+    constexpr void invoke(TData& data)
+    {
+        TOp()(data);
+    }
+};
+
+/* an invoker that does not run the operations, only the states change.  used to bring a process to the state it was in
+ without repeating the side effects of getting there */
+struct SkipInvoker
+{
+    /* does nothing */
+    template<typename TOwner, typename TOp, typename TData>
+    constexpr void invoke(TData&)
+    {
+    }
+};
+} // namespace states
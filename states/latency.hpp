@@ -0,0 +1,278 @@
+//
+//  latency.hpp
+//  states
+//
+//  Created by Daniel Pav on 10/19/26.
+//  Copyright © 2026 Daniel Pav. All rights reserved.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <type_traits>
+
+#include "cycles.hpp"
+#include "named.hpp"
+#include "noop.hpp"
+#include "typelist.hpp"
+
+namespace states
+{
+/* a histogram of tick counts with fixed log-linear buckets.  values below 8 have a bucket each, above that every power
+ of two is split into 8 equal buckets, so a bucket is never wider than 1/8th of its lower bound.  a histogram is meant
+ to be written by one thread.  histograms from several threads are combined with merge.
+ */
+class LatencyHistogram
+{
+public:
+    /* linear buckets per power of two */
+    static const constexpr unsigned subBits = 3;
+    /* number of buckets, enough for any 64 bit value */
+    static const constexpr size_t buckets = (64 - subBits + 1) << subBits;
+
+private:
+    /* returns the index of the highest set bit of a non-zero value */
+    static unsigned topBit(uint64_t value)
+    {
+#if defined(_MSC_VER)
+        unsigned long index;
+        _BitScanReverse64(&index, value);
+        return static_cast<unsigned>(index);
+#else
+        return 63 - static_cast<unsigned>(__builtin_clzll(value));
+#endif
+    }
+
+public:
+    /* returns the bucket holding the value */
+    static size_t bucket(uint64_t value)
+    {
+        if (value < (uint64_t(1) << subBits))
+            return static_cast<size_t>(value);
+        const unsigned top = topBit(value);
+        const unsigned shift = top - subBits;
+        const uint64_t sub = (value >> shift) & ((uint64_t(1) << subBits) - 1);
+        return static_cast<size_t>(((shift + 1) << subBits) + sub);
+    }
+
+    /* returns the smallest value held by the bucket */
+    static uint64_t lowest(size_t bucket)
+    {
+        if (bucket < (size_t(1) << subBits))
+            return bucket;
+        const unsigned shift = static_cast<unsigned>(bucket >> subBits) - 1;
+        const uint64_t sub = bucket & ((size_t(1) << subBits) - 1);
+        return ((uint64_t(1) << subBits) | sub) << shift;
+    }
+
+    /* returns the largest value held by the bucket */
+    static uint64_t highest(size_t bucket) { return (bucket + 1 < buckets) ? lowest(bucket + 1) - 1 : UINT64_MAX; }
+
+public:
+    /* adds one value */
+    void record(uint64_t value)
+    {
+        ++counts_[bucket(value)];
+        ++total_;
+        sum_ += value;
+    }
+
+    /* adds all the values of the other histogram */
+    void merge(const LatencyHistogram& other)
+    {
+        for (size_t i = 0; i < buckets; ++i)
+            counts_[i] += other.counts_[i];
+        total_ += other.total_;
+        sum_ += other.sum_;
+    }
+
+    /* removes all values */
+    void clear() { *this = LatencyHistogram(); }
+
+    /* returns the number of values in the bucket */
+    uint64_t count(size_t bucket) const { return counts_[bucket]; }
+    /* returns the number of values */
+    uint64_t count() const { return total_; }
+    /* returns the sum of the values */
+    uint64_t sum() const { return sum_; }
+
+    /* returns the upper bound of the bucket holding the q-th quantile (0 <= q <= 1), 0 when empty */
+    uint64_t quantile(double q) const
+    {
+        if (total_ == 0)
+            return 0;
+        const uint64_t rank = static_cast<uint64_t>(q * static_cast<double>(total_ - 1)) + 1;
+        uint64_t seen = 0;
+        for (size_t i = 0; i < buckets; ++i)
+        {
+            seen += counts_[i];
+            if (seen >= rank)
+                return highest(i);
+        }
+        return highest(buckets - 1);
+    }
+
+    /* dumps the count, mean and some quantiles (for debugging) */
+    void dump(std::ostream& os) const
+    {
+        os << "n=" << total_ << " mean=" << (total_ ? sum_ / total_ : 0) << " p50=" << quantile(0.5)
+           << " p99=" << quantile(0.99) << " p999=" << quantile(0.999) << " max=" << quantile(1.0);
+    }
+
+private:
+    /* number of values in each bucket */
+    uint64_t counts_[buckets]{};
+    /* number of values */
+    uint64_t total_{0};
+    /* sum of the values */
+    uint64_t sum_{0};
+};
+
+/* dumps the summary of the histogram (for debugging) */
+inline std::ostream& operator<<(std::ostream& os, const LatencyHistogram& obj)
+{
+    obj.dump(os);
+    return os;
+}
+
+/* one latency histogram for every link and every state of TMachine.  use one profile per thread and merge them to get
+ the totals.  visit calls the visitor with the names of each link or state next to its histogram:
+ visitor.visitLinkLatency(from, event, to, histogram) and visitor.visitStateLatency(state, histogram).
+ */
+template<typename TMachine>
+class LatencyProfile
+{
+public:
+    /* list of links, in the order of the machine */
+    using TLinkList = typename TMachine::TLinkList;
+    /* list of states */
+    using TStateTypes = typename TMachine::TStateTypes;
+    /* number of links */
+    static const constexpr size_t linkCount = TypeListSize<TLinkList>::size;
+    /* number of states */
+    static const constexpr size_t stateCount = TypeListSize<TStateTypes>::size;
+
+private:
+    /* visit case for a link, visit it then the other links */
+    template<typename TVisitor, typename TList>
+    void visitLinks(TVisitor& visitor, size_t index, const TList*) const
+    {
+        using TLink = typename TList::TCurrentType;
+        using TNext = typename TList::TNextType;
+        visitor.visitLinkLatency(TLink::TFromType::name(), TLink::TEventType::name(), TLink::TToType::name(),
+                                 links_[index]);
+        visitLinks(visitor, index + 1, static_cast<const TNext*>(nullptr));
+    }
+
+    /* base case for visiting the links, do nothing */
+    template<typename TVisitor>
+    void visitLinks(TVisitor&, size_t, const TypeListEnd*) const
+    {
+    }
+
+public:
+    /* records the ticks taken by the op of TOwner, where TOwner is a link of the machine */
+    template<typename TOwner>
+    typename std::enable_if<TypeListContains<TLinkList, TOwner>::value>::type record(uint64_t ticks)
+    {
+        links_[TypeListIndex<TLinkList, TOwner>::index].record(ticks);
+    }
+
+    /* records the ticks taken by the op of TOwner, where TOwner is a state of the machine */
+    template<typename TOwner>
+    typename std::enable_if<TypeListContains<TStateTypes, TOwner>::value>::type record(uint64_t ticks)
+    {
+        states_[TypeListIndex<TStateTypes, TOwner>::index].record(ticks);
+    }
+
+    /* returns the histogram of the link at the index in the link list */
+    const LatencyHistogram& link(size_t index) const { return links_[index]; }
+    /* returns the histogram of the state at the index in the state list */
+    const LatencyHistogram& state(size_t index) const { return states_[index]; }
+
+    /* adds the values of the other profile, typically from another thread */
+    void merge(const LatencyProfile& other)
+    {
+        for (size_t i = 0; i < linkCount; ++i)
+            links_[i].merge(other.links_[i]);
+        for (size_t i = 0; i < stateCount; ++i)
+            states_[i].merge(other.states_[i]);
+    }
+
+    /* removes all values */
+    void clear()
+    {
+        for (size_t i = 0; i < linkCount; ++i)
+            links_[i].clear();
+        for (size_t i = 0; i < stateCount; ++i)
+            states_[i].clear();
+    }
+
+    /* visits every link and then every state with its histogram */
+    template<typename TVisitor>
+    void visit(TVisitor& visitor) const
+    {
+        visitLinks(visitor, 0, static_cast<const TLinkList*>(nullptr));
+        for (size_t i = 0; i < stateCount; ++i)
+            visitor.visitStateLatency(NamedAt<TStateTypes>::name(i), states_[i]);
+    }
+
+private:
+    /* histograms of the link ops */
+    LatencyHistogram links_[linkCount];
+    /* histograms of the state ops */
+    LatencyHistogram states_[stateCount];
+};
+
+/* an invoker that times every op with the tick counter and records the result in a profile.  NoOp ops are not timed.
+ the profile is not owned, so processes run by one thread share that thread's profile */
+template<typename TMachine>
+class TimingInvoker
+{
+public:
+    TimingInvoker(LatencyProfile<TMachine>& profile) : profile_(&profile) {}
+
+public:
+    /* runs the operation TOp of TOwner on the data, recording how long it took */
+    template<typename TOwner, typename TOp, typename TData>
+    typename std::enable_if<!std::is_same<TOp, NoOp>::value>::type invoke(TData& data)
+    {
+        const uint64_t start = Cycles::now();
+        TOp()(data);
+        profile_->template record<TOwner>(Cycles::now() - start);
+    }
+
+    /* does nothing for the NoOp */
+    template<typename TOwner, typename TOp, typename TData>
+    typename std::enable_if<std::is_same<TOp, NoOp>::value>::type invoke(TData&)
+    {
+    }
+
+private:
+    /* where the ticks are recorded */
+    LatencyProfile<TMachine>* profile_;
+};
+
+/* a visitor to dump a latency profile */
+class LatencyVisitor
+{
+public:
+    LatencyVisitor(std::ostream& os) : os_(os) {}
+
+public:
+    void visitLinkLatency(const char* from, const char* event, const char* to, const LatencyHistogram& histogram)
+    {
+        os_ << from << " -> " << to << " : " << event << " " << histogram << std::endl;
+    }
+    void visitStateLatency(const char* name, const LatencyHistogram& histogram)
+    {
+        os_ << name << " " << histogram << std::endl;
+    }
+
+private:
+    std::ostream& os_;
+};
+
+} // namespace states
@@ -8,9 +8,11 @@
 
 #pragma once
 
+#include "invoker.hpp"
 #include "noop.hpp"
 #include "state.hpp"
 #include "typenum.hpp"
+#include "wildcard.hpp"
 
 namespace states
 {
@@ -21,7 +23,8 @@ struct LinkKey
 };
 
 /* represents a transition in a state diagram.  indicates a link from TFrom to TTo when TEvent occurs.  When this is
- * traverse the TLinkOp is invoked.
+ * traverse the TLinkOp is invoked.  TFrom may be AnyState for a link from every state and TEvent may be AnyEvent for a
+ * link taken on every event, see Machine for which link is taken when several match.
  */
 template<typename TFrom, typename TEvent, typename TTo, typename TLinkOp = NoOp>
 class Link
@@ -35,31 +38,45 @@ public:
     using TToType = TTo;
     /* key is From, Event pair */
     using TKeyType = LinkKey<TFrom, TEvent>;
+    /* link op type */
+    using TLinkOpType = TLinkOp;
+    /* asserts that the link goes to a state */
+    static_assert(!std::is_same<TTo, AnyState>::value, "a link cannot go to any state");
 
 public:
     /* returns true if this link is relevant to this state and the event,
-     by which the state is the starting state for the link and the event matches */
+     by which the state is the starting state for the link and the event matches.  a wildcard link matches without
+     regard to more specific links */
     template<typename TStateNum, typename TEventNum>
-    static bool relevant(const TStateNum& state, const TEventNum& event)
+    static constexpr bool relevant(const TStateNum& state, const TEventNum& event)
     {
-        return event.template is<TEvent>() && state.template is<TFrom>();
+        return EventMatch<TEvent>::test(event) && FromMatch<TFrom>::test(state);
     }
 
     /* returns true if this link is relevant to this state and the event,
      by which the state is the starting state for the link and the event matches */
     template<typename TTestEvent, typename TStateNum>
-    static bool relevant(const TStateNum& state)
+    static constexpr bool relevant(const TStateNum& state)
     {
-        return std::is_same<TEvent, TTestEvent>::value && state.template is<TFrom>();
+        return (std::is_same<TEvent, TTestEvent>::value || std::is_same<TEvent, AnyEvent>::value) &&
+            FromMatch<TFrom>::test(state);
     }
 
     /* follow the link, by running the link operation on the data and the state operation on the data, changing the
      state to the new state */
     template<typename TData, typename TStateNum>
-    static void follow(TStateNum& state, TData& data)
+    static constexpr void follow(TStateNum& state, TData& data)
+    {
+        DirectInvoker invoker{};
+        follow(state, data, invoker);
+    }
+
+    /* follow the link, running the link operation and the state operation through the invoker */
+    template<typename TData, typename TStateNum, typename TInvoker>
+    static constexpr void follow(TStateNum& state, TData& data, TInvoker& invoker)
     {
-        TLinkOp()(data);
-        TTo::become(state, data);
+        invoker.template invoke<Link, TLinkOp>(data);
+        TTo::become(state, data, invoker);
     }
 
     /* visit the link by visiting the start and end state and then the event */
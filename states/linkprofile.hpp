@@ -0,0 +1,168 @@
+//
+//  linkprofile.hpp
+//  states
+//
+//  Created by Daniel Pav on 10/19/26.
+//  Copyright © 2026 Daniel Pav. All rights reserved.
+//
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+
+#include "typelist.hpp"
+
+namespace states
+{
+/* counts how often each link of TMachine is taken, to find the links that matter in a typical run.  the counts are
+ filled by processes with a LinkCounter observer and can be merged from several runs.  they are relaxed atomics, so
+ processes on several threads can share a profile; to keep them from contending, give each thread its own profile and
+ merge them at the end.  emit writes a header with the
+ LinkWeights of the machine, which WeightedMachine uses to try the links in order of their weights and to mark the
+ links never taken as unlikely.  the weights are the counts scaled to 1 to 1000, 0 for a link that was never taken.
+ */
+template<typename TMachine>
+class LinkProfile
+{
+public:
+    /* number of links */
+    static const constexpr size_t links = TMachine::linkCount;
+    /* largest weight */
+    static const constexpr uint64_t maxWeight = 1000;
+
+    LinkProfile() { clear(); }
+
+private:
+    /* collects the names of the links from a visit of the machine */
+    class NameVisitor
+    {
+    public:
+        NameVisitor(const char* (&names)[links][3]) : names_(names) {}
+
+    public:
+        void preLink() { field_ = 0; }
+        void inLink1() { field_ = 1; }
+        void inLink2() { field_ = 2; }
+        void postLink() { ++link_; }
+        void visitState(const char* name) { names_[link_][field_] = name; }
+        void visitEvent(const char* name) { names_[link_][field_] = name; }
+
+    private:
+        const char* (&names_)[links][3];
+        size_t link_{0};
+        size_t field_{0};
+    };
+
+public:
+    /* counts the link from the state for the event, if there is one */
+    template<typename TStateNum, typename TEventNum>
+    void record(const TStateNum& from, const TEventNum& event)
+    {
+        const size_t link = TMachine::link(from.get(), event.get());
+        if (link < links)
+            counts_[link].fetch_add(1, std::memory_order_relaxed);
+    }
+
+    /* returns the number of times the link at the index was taken */
+    uint64_t count(size_t link) const { return (link < links) ? counts_[link].load(std::memory_order_relaxed) : 0; }
+
+    /* returns the largest count */
+    uint64_t most() const
+    {
+        uint64_t most = 0;
+        for (size_t i = 0; i < links; ++i)
+            most = (count(i) > most) ? count(i) : most;
+        return most;
+    }
+
+    /* returns the weight of the link at the index */
+    uint64_t weight(size_t link) const { return scale(count(link), most()); }
+
+    /* adds the counts of the other profile */
+    void merge(const LinkProfile& other)
+    {
+        for (size_t i = 0; i < links; ++i)
+            counts_[i].fetch_add(other.count(i), std::memory_order_relaxed);
+    }
+
+    /* sets every count to 0 */
+    void clear()
+    {
+        for (size_t i = 0; i < links; ++i)
+            counts_[i].store(0, std::memory_order_relaxed);
+    }
+
+    /* writes a header defining the type name as the LinkWeights of the machine, with the link and its count next to
+     each weight */
+    void emit(std::ostream& os, const char* name) const
+    {
+        const char* names[links][3] = {};
+        NameVisitor visitor(names);
+        TMachine::visit(visitor);
+        const uint64_t largest = most();
+        os << "//" << std::endl;
+        os << "//  generated by states::LinkProfile, do not edit" << std::endl;
+        os << "//" << std::endl << std::endl;
+        os << "#pragma once" << std::endl << std::endl;
+        os << "#include \"weightedmachine.hpp\"" << std::endl << std::endl;
+        os << "using " << name << " = states::LinkWeights<";
+        for (size_t i = 0; i < links; ++i)
+        {
+            const uint64_t n = count(i);
+            os << std::endl << "    " << scale(n, largest) << ((i + 1 < links) ? ", " : "  ");
+            os << "/* " << names[i][0] << " -> " << names[i][1] << " : " << names[i][2] << ", " << n << " */";
+        }
+        os << ">;" << std::endl;
+    }
+
+private:
+    /* returns the count scaled to 1 to maxWeight against the largest count, 0 for 0 */
+    static uint64_t scale(uint64_t n, uint64_t most)
+    {
+        if (n == 0)
+            return 0;
+        const uint64_t scaled = static_cast<uint64_t>(static_cast<double>(n) * maxWeight / static_cast<double>(most));
+        return (scaled != 0) ? scaled : 1;
+    }
+
+private:
+    /* times each link was taken */
+    std::atomic<uint64_t> counts_[links];
+};
+
+/* an observer that counts the links taken by a process in a LinkProfile, which may be shared by several processes */
+template<typename TMachine>
+class LinkCounter
+{
+public:
+    LinkCounter(LinkProfile<TMachine>& profile) : profile_(&profile) {}
+
+public:
+    /* does nothing */
+    template<typename TStateNum>
+    void onStart(const TStateNum&)
+    {
+    }
+
+    /* counts the link taken */
+    template<typename TStateNum, typename TEventNum>
+    void onTransition(const TStateNum& from, const TEventNum& event, const TStateNum&)
+    {
+        profile_->record(from, event);
+    }
+
+    /* does nothing */
+    template<typename TStateNum>
+    void onReset(const TStateNum&)
+    {
+    }
+
+private:
+    /* where the links are counted */
+    LinkProfile<TMachine>* profile_;
+};
+
+} // namespace states
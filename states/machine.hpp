@@ -8,7 +8,10 @@
 
 #pragma once
 
+#include "bitset.hpp"
+#include "invoker.hpp"
 #include "typenum.hpp"
+#include "wildcard.hpp"
 
 namespace states
 {
@@ -17,6 +20,12 @@ namespace states
  2. an event num which can be any of the event states
  3. handle an event which finds the link that has the same from state and the same event and follows it
  4. process a state which means to run the state's operation
+ a link from AnyState leaves every state and a link on AnyEvent is taken for every event, neither is a state or an event
+ of the machine.  they are expanded into the transition table when it is built, at compile time, and when several links
+ match a state and an event the most specific is taken: first a link from the state on the event, then a link from the
+ state on any event, then a link from any state on the event and last a link from any state on any event.  handle with
+ an event num looks up the link in the table, so a wildcard link costs the same as any other, and handle with an event
+ type compares the state with only the links that can be taken for that event.
  */
 template<typename... TLinks>
 class Machine
@@ -24,18 +33,30 @@ class Machine
 public:
     /* list of links */
     using TLinkList = TypeList<TLinks...>;
-    /* list of unique states that are start states */
-    using TFromStateTypes = TypeListUnique<typename TLinks::TFromType...>;
+    /* list of unique states that are start states, without AnyState */
+    using TFromStateTypes = typename TypeListRemove<TypeListUnique<typename TLinks::TFromType...>, AnyState>::TType;
     /* list of unique states that are end states */
     using TToStateTypes = TypeListUnique<typename TLinks::TToType...>;
-    /* list of unique states that are start or end states */
-    using TStateTypes = TypeListUnique<typename TLinks::TFromType..., typename TLinks::TToType...>;
+    /* list of unique states that are start or end states, without AnyState */
+    using TStateTypes = typename TypeListRemove<
+        TypeListUnique<typename TLinks::TFromType..., typename TLinks::TToType...>, AnyState>::TType;
     /* typenum representing a state from the list of unique states */
     using TStateNum = TypeNum<TStateTypes>;
-    /* list of unique events */
-    using TEventTypes = TypeListUnique<typename TLinks::TEventType...>;
+    /* list of unique events, without AnyEvent */
+    using TEventTypes = typename TypeListRemove<TypeListUnique<typename TLinks::TEventType...>, AnyEvent>::TType;
     /* typenum representing an event from the list of unique events */
     using TEventNum = TypeNum<TEventTypes>;
+    /* list of unique ops of the links and the states */
+    using TOpTypes = TypeListUnique<typename TLinks::TLinkOpType..., typename TLinks::TFromType::TStateOpType...,
+                                    typename TLinks::TToType::TStateOpType...>;
+    /* number of states */
+    static const constexpr size_t stateCount = TypeListSize<TStateTypes>::size;
+    /* number of events */
+    static const constexpr size_t eventCount = TypeListSize<TEventTypes>::size;
+    /* number of links */
+    static const constexpr size_t linkCount = sizeof...(TLinks);
+    /* set of events, one bit per event index */
+    using TEventMask = BitSet<eventCount>;
 
 private:
     /* non-unique list of key types */
@@ -46,65 +67,171 @@ private:
     static_assert(TypeListSize<TKeyTypes>::size == TypeListSize<TUniqueKeyTypes>::size,
                   "set of links must have unique set of from/event pairs.");
 
+    /* the state each state goes to for each event and the index of the link taken, npos where there is no link, with a
+     last row of npos for no-state */
+    struct TTransitionTable
+    {
+        size_t to[stateCount + 1][eventCount];
+        size_t link[stateCount + 1][eventCount];
+    };
+
+    /* builds the transition table by setting the to state and index of each link in the rows of its from state for its
+     event.  AnyState and AnyEvent have no index, so their links are set in every row or column.  the links are set from
+     the least specific to the most specific so that the most specific one is left in the table */
+    static constexpr TTransitionTable makeTransitionTable()
+    {
+        TTransitionTable table{};
+        for (size_t s = 0; s <= stateCount; ++s)
+            for (size_t e = 0; e < eventCount; ++e)
+            {
+                table.to[s][e] = TypeListIndexBase::npos;
+                table.link[s][e] = TypeListIndexBase::npos;
+            }
+        const size_t npos = TypeListIndexBase::npos;
+        const size_t from[] = {TypeListIndex<TStateTypes, typename TLinks::TFromType>::index...};
+        const size_t event[] = {TypeListIndex<TEventTypes, typename TLinks::TEventType>::index...};
+        const size_t to[] = {TypeListIndex<TStateTypes, typename TLinks::TToType>::index...};
+        for (size_t rank = 0; rank < 4; ++rank)
+            for (size_t i = 0; i < sizeof...(TLinks); ++i)
+            {
+                if (((from[i] != npos) ? 2u : 0u) + ((event[i] != npos) ? 1u : 0u) != rank)
+                    continue;
+                for (size_t s = 0; s < stateCount; ++s)
+                    for (size_t e = 0; e < eventCount; ++e)
+                        if ((from[i] == npos || from[i] == s) && (event[i] == npos || event[i] == e))
+                        {
+                            table.to[s][e] = to[i];
+                            table.link[s][e] = i;
+                        }
+            }
+        return table;
+    }
+
+    /* the state each state goes to for each event */
+    static constexpr const TTransitionTable transitionTable_ = makeTransitionTable();
+
+    /* the events accepted by each state, with a last, empty row for no-state */
+    struct TAcceptTable
+    {
+        TEventMask masks[stateCount + 1];
+    };
+
+    /* builds the accept table by setting the events that have a link in the transition table */
+    static constexpr TAcceptTable makeAcceptTable()
+    {
+        TAcceptTable table{};
+        for (size_t s = 0; s < stateCount; ++s)
+            for (size_t e = 0; e < eventCount; ++e)
+                if (transitionTable_.link[s][e] != TypeListIndexBase::npos)
+                    table.masks[s].set(e);
+        return table;
+    }
+
+    /* the events accepted by each state */
+    static constexpr const TAcceptTable acceptTable_ = makeAcceptTable();
+
 private:
-    /* link case for handle by event type, if relevant, follow link, else try others */
-    template<typename TEvent, typename TData, typename TFirst, typename... TOthers>
-    static bool handleImpl(TStateNum& state, TData& data)
+    /* link case for handle, if the link is the one at the index, follow it, else try the others */
+    template<typename TData, typename TInvoker, typename TFirst, typename... TOthers>
+    static constexpr bool followImpl(size_t index, TStateNum& state, TData& data, TInvoker& invoker)
     {
-        if (TFirst::template relevant<TEvent>(state))
+        if (index == linkCount - 1 - sizeof...(TOthers))
         {
-            TFirst::follow(state, data);
+            TFirst::follow(state, data, invoker);
             return true;
         }
-        return handleImpl<TEvent, TData, TOthers...>(state, data);
+        return followImpl<TData, TInvoker, TOthers...>(index, state, data, invoker);
     }
 
-    /* base case for handle by event type, do nothing */
-    template<typename TEvent, typename TData>
-    static bool handleImpl(TStateNum& state, TData& data)
+    /* base case for handle, there is no link at the index, do nothing */
+    template<typename TData, typename TInvoker>
+    static constexpr bool followImpl(size_t index, TStateNum& state, TData& data, TInvoker& invoker)
     {
         return false;
     }
 
-    /* link case for handle by event num, if relevant, follow link, else try others */
-    template<typename TData, typename TFirst, typename... TOthers>
-    static bool handleImpl(TStateNum& state, const TEventNum& event, TData& data)
+    /* the rank of the link TLink, higher when more specific: 2 if it is from a state and 1 more if it is on an event */
+    template<typename TLink>
+    struct LinkRank
     {
-        if (TFirst::relevant(state, event))
-        {
-            TFirst::follow(state, data);
-            return true;
-        }
-        return handleImpl<TData, TOthers...>(state, event, data);
+        static const constexpr size_t rank = (std::is_same<typename TLink::TFromType, AnyState>::value ? 0u : 2u) +
+            (std::is_same<typename TLink::TEventType, AnyEvent>::value ? 0u : 1u);
+    };
+
+    /* whether the typed handle tries the link TLink for the event TEvent at the rank */
+    template<typename TEvent, size_t rank, typename TLink>
+    using TTakes = std::integral_constant<
+        bool, LinkRank<TLink>::rank == rank && (std::is_same<typename TLink::TEventType, TEvent>::value ||
+                                                std::is_same<typename TLink::TEventType, AnyEvent>::value)>;
+
+    /* follows the link if it leaves the state, returns true if it did */
+    template<typename TLink, typename TData, typename TInvoker>
+    static constexpr bool takeImpl(TStateNum& state, TData& data, TInvoker& invoker, std::true_type)
+    {
+        if (!FromMatch<typename TLink::TFromType>::test(state))
+            return false;
+        TLink::follow(state, data, invoker);
+        return true;
     }
 
-    /* base case for handle by event num, do nothing */
-    template<typename TData>
-    static bool handleImpl(TStateNum& state, const TEventNum& event, TData& data)
+    /* the link is not taken for the event at the rank */
+    template<typename TLink, typename TData, typename TInvoker>
+    static constexpr bool takeImpl(TStateNum&, TData&, TInvoker&, std::false_type)
+    {
+        return false;
+    }
+
+    /* link case for the typed handle, tries the first link if it is taken for TEvent at the rank, else the others */
+    template<typename TEvent, size_t rank, typename TData, typename TInvoker, typename TList>
+    static constexpr bool handleImpl(TStateNum& state, TData& data, TInvoker& invoker, const TList*)
+    {
+        using TLink = typename TList::TCurrentType;
+        return takeImpl<TLink>(state, data, invoker, TTakes<TEvent, rank, TLink>()) ||
+            handleImpl<TEvent, rank>(state, data, invoker, static_cast<const typename TList::TNextType*>(nullptr));
+    }
+
+    /* end of the links at the rank, tries the links at the rank below */
+    template<typename TEvent, size_t rank, typename TData, typename TInvoker>
+    static constexpr bool handleImpl(TStateNum& state, TData& data, TInvoker& invoker, const TypeListEnd*)
+    {
+        return handleBelow<TEvent, rank>(state, data, invoker, std::integral_constant<bool, rank != 0>());
+    }
+
+    /* tries the links at the rank below */
+    template<typename TEvent, size_t rank, typename TData, typename TInvoker>
+    static constexpr bool handleBelow(TStateNum& state, TData& data, TInvoker& invoker, std::true_type)
+    {
+        return handleImpl<TEvent, rank - 1>(state, data, invoker, static_cast<const TLinkList*>(nullptr));
+    }
+
+    /* base case for the typed handle, no link leaves the state on the event */
+    template<typename TEvent, size_t rank, typename TData, typename TInvoker>
+    static constexpr bool handleBelow(TStateNum&, TData&, TInvoker&, std::false_type)
     {
         return false;
     }
 
     /* invokes the operation on the data for the state and returns true (always) for success */
-    template<typename TData, typename TState>
-    static bool invokeImpl(TData& data)
+    template<typename TData, typename TInvoker, typename TState>
+    static constexpr bool invokeImpl(TData& data, TInvoker& invoker)
     {
-        TState::invoke(data);
+        TState::invoke(data, invoker);
         return true;
     }
 
-    /* link case for process, if the link has the same statrt state, process else try the other links */
-    template<typename TData, typename TFirst, typename... TOthers>
-    static bool processImpl(const TStateNum& state, TData& data)
+    /* state case for process, if the state is the first of the start states, process else try the other states */
+    template<typename TData, typename TInvoker, typename TList>
+    static constexpr bool processImpl(const TStateNum& state, TData& data, TInvoker& invoker, const TList*)
     {
-        using TState = typename TFirst::TFromType;
-        return state.template is<TState>() ? invokeImpl<TData, TState>(data)
-                                           : processImpl<TData, TOthers...>(state, data);
+        using TState = typename TList::TCurrentType;
+        return state.template is<TState>()
+            ? invokeImpl<TData, TInvoker, TState>(data, invoker)
+            : processImpl(state, data, invoker, static_cast<const typename TList::TNextType*>(nullptr));
     }
 
     /* base case for process, do nothing */
-    template<typename TData>
-    static bool processImpl(const TStateNum& state, TData& data)
+    template<typename TData, typename TInvoker>
+    static constexpr bool processImpl(const TStateNum& state, TData& data, TInvoker& invoker, const TypeListEnd*)
     {
         return false;
     }
@@ -127,27 +254,81 @@ public:
     /* handle an event, will change the state, following the appropriate link, performing the link op and the new state
        op returns true if handled */
     template<typename TEvent, typename TData>
-    static typename std::enable_if<TypeListContains<TEventTypes, TEvent>::value, bool>::type handle(TStateNum& state,
-                                                                                                    TData& data)
+    static constexpr typename std::enable_if<TypeListContains<TEventTypes, TEvent>::value, bool>::type handle(
+        TStateNum& state, TData& data)
+    {
+        DirectInvoker invoker{};
+        return handle<TEvent>(state, data, invoker);
+    }
+
+    /* handle an event as above, running the ops through the invoker.  the links on TEvent or AnyEvent are picked out at
+     compile time and tried from the most specific, so only the state is compared at run time */
+    template<typename TEvent, typename TData, typename TInvoker>
+    static constexpr typename std::enable_if<TypeListContains<TEventTypes, TEvent>::value, bool>::type handle(
+        TStateNum& state, TData& data, TInvoker& invoker)
     {
-        return handleImpl<TEvent, TData, TLinks...>(state, data);
+        return handleImpl<TEvent, 3>(state, data, invoker, static_cast<const TLinkList*>(nullptr));
     }
 
     /* handles the transition from the state using the event given
      advances the state, returns true if tthe state is valid and
      can be advanced */
     template<typename TData>
-    static bool handle(TStateNum& state, const TEventNum& event, TData& data)
+    static constexpr bool handle(TStateNum& state, const TEventNum& event, TData& data)
     {
-        return handleImpl<TData, TLinks...>(state, event, data);
+        DirectInvoker invoker{};
+        return handle(state, event, data, invoker);
+    }
+
+    /* handles the transition as above, running the ops through the invoker */
+    template<typename TData, typename TInvoker>
+    static constexpr bool handle(TStateNum& state, const TEventNum& event, TData& data, TInvoker& invoker)
+    {
+        return followImpl<TData, TInvoker, TLinks...>(link(state.get(), event.get()), state, data, invoker);
     }
 
     /* process the current given state, without advancing in any way
         returns true if state is valid */
     template<typename TData>
-    static bool process(const TStateNum& state, TData& data)
+    static constexpr bool process(const TStateNum& state, TData& data)
+    {
+        DirectInvoker invoker{};
+        return process(state, data, invoker);
+    }
+
+    /* process the current given state as above, running the op through the invoker */
+    template<typename TData, typename TInvoker>
+    static constexpr bool process(const TStateNum& state, TData& data, TInvoker& invoker)
+    {
+        return processImpl(state, data, invoker, static_cast<const TFromStateTypes*>(nullptr));
+    }
+
+    /* returns the set of events that have a link from the state, empty if the state is not valid */
+    static constexpr const TEventMask& accepted(const TStateNum& state)
+    {
+        return acceptTable_.masks[state.valid() ? state.get() : stateCount];
+    }
+
+    /* returns true if the event has a link from the state */
+    static constexpr bool accepts(const TStateNum& state, const TEventNum& event)
+    {
+        return accepted(state).test(event.get());
+    }
+
+    /* returns the index of the state that the link from the state index for the event index goes to, without following
+     it.  npos if the state or the event is npos or there is no link */
+    static constexpr size_t target(size_t state, size_t event)
     {
-        return processImpl<TData, TLinks...>(state, data);
+        return (event < eventCount) ? transitionTable_.to[(state < stateCount) ? state : stateCount][event]
+                                    : TypeListIndexBase::npos;
+    }
+
+    /* returns the 0-based index in TLinkList of the link from the state index for the event index.  npos if the state
+     or the event is npos or there is no link */
+    static constexpr size_t link(size_t state, size_t event)
+    {
+        return (event < eventCount) ? transitionTable_.link[(state < stateCount) ? state : stateCount][event]
+                                    : TypeListIndexBase::npos;
     }
 
     /* visit the machine by visiting its links */
@@ -158,4 +339,12 @@ public:
     }
 };
 
+/* definition of the accept table */
+template<typename... TLinks>
+constexpr const typename Machine<TLinks...>::TAcceptTable Machine<TLinks...>::acceptTable_;
+
+/* definition of the transition table */
+template<typename... TLinks>
+constexpr const typename Machine<TLinks...>::TTransitionTable Machine<TLinks...>::transitionTable_;
+
 } // namespace states
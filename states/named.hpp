@@ -8,6 +8,11 @@
 
 #pragma once
 
+#include <cstddef>
+#include <cstring>
+
+#include "typelist.hpp"
+
 namespace states
 {
 /* converts a const char * template parameter into a const char * name function */
@@ -16,6 +21,50 @@ class Named
 {
 public:
     /* returns the name that is the template parameter */
-    static const char* name() { return Name; }
+    static constexpr const char* name() { return Name; }
+};
+
+/* looks up the name of the type at a 0-based index of the type list TList, where every type in TList has a name
+ function (states and events).  returns nullptr if the index is out of range */
+template<typename TList>
+struct NamedAt
+{
+    static const char* name(size_t index)
+    {
+        return (index == 0) ? TList::TCurrentType::name() : NamedAt<typename TList::TNextType>::name(index - 1);
+    }
+};
+
+template<>
+struct NamedAt<TypeListEnd>
+{
+    static const char* name(size_t) { return nullptr; }
+};
+
+/* looks up the 0-based index of a type in the type list TList by its name, where every type in TList has a name
+ function.  find compares the text of the names, findSame the addresses, which is enough for a name given by the type
+ itself.  both return npos if there is no such type */
+template<typename TList>
+struct NamedIndex
+{
+    static size_t find(const char* name, size_t index = 0)
+    {
+        return (std::strcmp(TList::TCurrentType::name(), name) == 0)
+            ? index
+            : NamedIndex<typename TList::TNextType>::find(name, index + 1);
+    }
+
+    static size_t findSame(const char* name, size_t index = 0)
+    {
+        return (TList::TCurrentType::name() == name) ? index
+                                                     : NamedIndex<typename TList::TNextType>::findSame(name, index + 1);
+    }
+};
+
+template<>
+struct NamedIndex<TypeListEnd>
+{
+    static size_t find(const char*, size_t = 0) { return TypeListIndexBase::npos; }
+    static size_t findSame(const char*, size_t = 0) { return TypeListIndexBase::npos; }
 };
 } // namespace states
@@ -0,0 +1,253 @@
+//
+//  nfa.hpp
+//  states
+//
+//  Created by Daniel Pav on 10/19/26.
+//  Copyright © 2026 Daniel Pav. All rights reserved.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#include "bitset.hpp"
+#include "noop.hpp"
+#include "process.hpp"
+#include "typelist.hpp"
+#include "typenum.hpp"
+#include "wildcard.hpp"
+
+namespace states
+{
+/* a set of links like Machine in which several links may have the same from state and event, a non-deterministic
+ machine.  it is run on a set of states at once, one bit per state of TStateTypes: on an event each state of the set
+ goes to every state it has a link to, and the new set is all of them.  for every event the set of states with a link
+ on it and, for every state, the set of states its links on it go to are built at compile time, so a step is a mask of
+ the set followed by an or of the sets of the states left in it, word by word.  up to 64 states the set is a single 64
+ bit word.  a link from AnyState or on AnyEvent adds its state to every state or event, it does not give way to other
+ links.  the links and states must not have ops, as there is no one path to run them on.
+ */
+template<typename... TLinks>
+class NfaMachine
+{
+public:
+    /* list of links */
+    using TLinkList = TypeList<TLinks...>;
+    /* list of unique states that are start states, without AnyState */
+    using TFromStateTypes = typename TypeListRemove<TypeListUnique<typename TLinks::TFromType...>, AnyState>::TType;
+    /* list of unique states that are end states */
+    using TToStateTypes = TypeListUnique<typename TLinks::TToType...>;
+    /* list of unique states that are start or end states, without AnyState */
+    using TStateTypes = typename TypeListRemove<
+        TypeListUnique<typename TLinks::TFromType..., typename TLinks::TToType...>, AnyState>::TType;
+    /* typenum representing a state from the list of unique states */
+    using TStateNum = TypeNum<TStateTypes>;
+    /* list of unique events, without AnyEvent */
+    using TEventTypes = typename TypeListRemove<TypeListUnique<typename TLinks::TEventType...>, AnyEvent>::TType;
+    /* typenum representing an event from the list of unique events */
+    using TEventNum = TypeNum<TEventTypes>;
+    /* list of unique ops of the links and the states */
+    using TOpTypes = TypeListUnique<typename TLinks::TLinkOpType..., typename TLinks::TFromType::TStateOpType...,
+                                    typename TLinks::TToType::TStateOpType...>;
+    /* number of states */
+    static const constexpr size_t stateCount = TypeListSize<TStateTypes>::size;
+    /* number of events */
+    static const constexpr size_t eventCount = TypeListSize<TEventTypes>::size;
+    /* number of links */
+    static const constexpr size_t linkCount = sizeof...(TLinks);
+    /* set of states, one bit per state index */
+    using TStateSet = BitSet<stateCount>;
+    /* asserts that nothing has an op */
+    static_assert(TypeListSize<TOpTypes>::size == 1 && TypeListContains<TOpTypes, NoOp>::value,
+                  "the links and states of an nfa cannot have ops");
+
+private:
+    /* for every event the states that have a link on it and the states each state goes to on it */
+    struct TStepTable
+    {
+        TStateSet from[eventCount];
+        TStateSet to[eventCount][stateCount];
+    };
+
+    /* builds the step table by adding each link to the sets of its event and from state, every event and state for
+     AnyEvent and AnyState */
+    static constexpr TStepTable makeStepTable()
+    {
+        TStepTable table{};
+        const size_t npos = TypeListIndexBase::npos;
+        const size_t from[] = {TypeListIndex<TStateTypes, typename TLinks::TFromType>::index...};
+        const size_t event[] = {TypeListIndex<TEventTypes, typename TLinks::TEventType>::index...};
+        const size_t to[] = {TypeListIndex<TStateTypes, typename TLinks::TToType>::index...};
+        for (size_t i = 0; i < sizeof...(TLinks); ++i)
+            for (size_t e = 0; e < eventCount; ++e)
+                for (size_t s = 0; s < stateCount; ++s)
+                    if ((event[i] == npos || event[i] == e) && (from[i] == npos || from[i] == s))
+                    {
+                        table.from[e].set(s);
+                        table.to[e][s].set(to[i]);
+                    }
+        return table;
+    }
+
+    /* the step table */
+    static constexpr const TStepTable stepTable_ = makeStepTable();
+
+    /* returns the index of the lowest set bit of a non-zero word */
+    static unsigned lowBit(uint64_t bits)
+    {
+#if defined(_MSC_VER)
+        unsigned long index;
+        _BitScanForward64(&index, bits);
+        return static_cast<unsigned>(index);
+#else
+        return static_cast<unsigned>(__builtin_ctzll(bits));
+#endif
+    }
+
+    /* visits the static structure of the machine, by visiting the first link and then each subsequent link */
+    template<typename TVisitor, typename TFirst, typename... TOthers>
+    static void visitImpl(TVisitor& visitor)
+    {
+        TFirst::visit(visitor);
+        visitImpl<TVisitor, TOthers...>(visitor);
+    }
+
+    /* visits the static structure of the machine */
+    template<typename TVisitor>
+    static void visitImpl(TVisitor& visitor)
+    {
+    }
+
+public:
+    /* returns the set of states that the states of the set go to on the event index, empty if none of them has a link
+     on it or the event is npos */
+    static TStateSet step(const TStateSet& active, size_t event)
+    {
+        TStateSet next{};
+        if (event >= eventCount)
+            return next;
+        const TStateSet live = active & stepTable_.from[event];
+        for (size_t w = 0; w < TStateSet::words; ++w)
+            for (uint64_t bits = live.word(w); bits != 0; bits &= bits - 1)
+                next |= stepTable_.to[event][w * 64 + lowBit(bits)];
+        return next;
+    }
+
+    /* returns true if a state of the set has a link on the event index */
+    static constexpr bool accepts(const TStateSet& active, size_t event)
+    {
+        return (event < eventCount) && (active & stepTable_.from[event]).any();
+    }
+
+    /* returns the set of states the state index goes to on the event index, empty if either is npos */
+    static constexpr TStateSet target(size_t state, size_t event)
+    {
+        return (state < stateCount && event < eventCount) ? stepTable_.to[event][state] : TStateSet{};
+    }
+
+    /* visit the machine by visiting its links */
+    template<typename TVisitor>
+    static void visit(TVisitor& visitor)
+    {
+        visitImpl<TVisitor, TLinks...>(visitor);
+    }
+};
+
+/* definition of the step table */
+template<typename... TLinks>
+constexpr const typename NfaMachine<TLinks...>::TStepTable NfaMachine<TLinks...>::stepTable_;
+
+/* runs an NfaMachine from TBegin, with the set of states it could be in.  the process is done when TEnd is in the set.
+ an event none of the states has a link on leaves the set as it was and next returns false, as with Process */
+template<typename TMachine, typename TBegin, typename TEnd>
+class NfaProcess
+{
+public:
+    /* the machine */
+    using TMachineType = TMachine;
+    /* the begin state */
+    using TBeginType = TBegin;
+    /* the end state */
+    using TEndType = TEnd;
+    /* the set of states */
+    using TStateSet = typename TMachine::TStateSet;
+    /* the event num type using the events from the machine given */
+    using TEventNum = typename TMachine::TEventNum;
+    /* asserts that the begin state is in the from states */
+    static_assert(TypeListContains<typename TMachine::TFromStateTypes, TBegin>::value, "");
+    /* asserts that the end state is in the to states */
+    static_assert(TypeListContains<typename TMachine::TToStateTypes, TEnd>::value, "");
+    /* make sure the end is reachable from the begin */
+    static_assert(Reachable<TMachine, TBegin, TEnd>::value, "End not reachable from Begin");
+
+private:
+    /* index of the begin state */
+    static const constexpr size_t begin = TypeListIndex<typename TMachine::TStateTypes, TBegin>::index;
+    /* index of the end state */
+    static const constexpr size_t end = TypeListIndex<typename TMachine::TStateTypes, TEnd>::index;
+
+public:
+    /* empties the set, equivalent to newly constructed */
+    void reset() { active_ = TStateSet{}; }
+
+    /* sets the set to the TBegin state only */
+    void start()
+    {
+        active_ = TStateSet{};
+        active_.set(begin);
+    }
+
+    /* moves the set on the event, returns true if a state of the set has a link on it */
+    bool next(const TEventNum& event)
+    {
+        const TStateSet next = TMachine::step(active_, event.get());
+        if (next.none())
+            return false;
+        active_ = next;
+        return true;
+    }
+
+    /* moves the set on the event TEvent, returns true if a state of the set has a link on it */
+    template<typename TEvent>
+    typename std::enable_if<TypeListContains<typename TMachine::TEventTypes, TEvent>::value, bool>::type next()
+    {
+        TEventNum event{};
+        event.template set<TEvent>();
+        return next(event);
+    }
+
+    /* returns true if the state TState is in the set */
+    template<typename TState>
+    typename std::enable_if<TypeListContains<typename TMachine::TStateTypes, TState>::value, bool>::type at() const
+    {
+        return active_.test(TypeListIndex<typename TMachine::TStateTypes, TState>::index);
+    }
+
+    /* returns true if a state of the set has a link on the event, without moving */
+    bool accepts(const TEventNum& event) const { return TMachine::accepts(active_, event.get()); }
+
+    /* returns true if TEnd is in the set */
+    bool done() const { return active_.test(end); }
+
+    /* returns the set of states */
+    const TStateSet& active() const { return active_; }
+
+    /* visits the process by visiting its machine and its begin and end states */
+    template<typename TVisitor>
+    static void visit(TVisitor& visitor)
+    {
+        visitor.preProcess();
+        visitor.visitBegin(TBegin::name());
+        TMachine::visit(visitor);
+        visitor.visitEnd(TEnd::name());
+        visitor.postProcess();
+    }
+
+private:
+    /* the states the process could be in */
+    TStateSet active_{};
+};
+
+} // namespace states
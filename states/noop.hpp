@@ -15,7 +15,7 @@ struct NoOp
 {
     /* does nothing */
     template<typename T>
-    void operator()(T&)
+    constexpr void operator()(T&)
     {
     }
 };
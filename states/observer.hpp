@@ -0,0 +1,35 @@
+//
+//  observer.hpp
+//  states
+//
+//  Created by Daniel Pav on 10/19/26.
+//  Copyright © 2026 Daniel Pav. All rights reserved.
+//
+
+#pragma once
+
+namespace states
+{
+/* provides a default to observe nothing.  an observer is told by the process about every change of its state:
+ onStart after start, onTransition after a link is followed and onReset before the state is cleared */
+struct NoObserver
+{
+    /* does nothing */
+    template<typename TStateNum>
+    constexpr void onStart(const TStateNum&)
+    {
+    }
+
+    /* does nothing */
+    template<typename TStateNum, typename TEventNum>
+    constexpr void onTransition(const TStateNum&, const TEventNum&, const TStateNum&)
+    {
+    }
+
+    /* does nothing */
+    template<typename TStateNum>
+    constexpr void onReset(const TStateNum&)
+    {
+    }
+};
+} // namespace states
@@ -0,0 +1,221 @@
+//
+//  occupancy.hpp
+//  states
+//
+//  Created by Daniel Pav on 10/19/26.
+//  Copyright © 2026 Daniel Pav. All rights reserved.
+//
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <type_traits>
+
+#include "named.hpp"
+#include "typelist.hpp"
+
+namespace states
+{
+/* counts how many processes of TMachine are in each state, for processes with an OccupancyCounter observer.  a start
+ adds one to the begin state, a transition moves one from the from state to the to state and a reset takes one from the
+ state left, as does the destruction of a process in a state.  the counts are kept in TShards shards so that threads do
+ not share a cache line: each thread counts in its own shard, and count and snapshot add up the shards.  a process may
+ move between threads, so the count of one shard may be negative, but the sums are right.  thresholds can be set for
+ states; check reports each state whose count went to or above its threshold, or back below it, since the last check.
+ */
+template<typename TMachine, size_t TShards = 16>
+class Occupancy
+{
+public:
+    /* number of states */
+    static const constexpr size_t states = TMachine::stateCount;
+    /* no threshold */
+    static const constexpr int64_t noThreshold = INT64_MAX;
+
+    Occupancy()
+    {
+        clear();
+        for (size_t s = 0; s < states; ++s)
+        {
+            thresholds_[s] = noThreshold;
+            over_[s] = false;
+        }
+    }
+
+private:
+    Occupancy(const Occupancy&) = delete;
+    Occupancy& operator=(const Occupancy&) = delete;
+
+    /* the counts of a shard, on their own cache lines */
+    struct alignas(64) Shard
+    {
+        std::atomic<int64_t> counts[states];
+    };
+
+    /* returns the shard of the calling thread */
+    Shard& shard()
+    {
+        static std::atomic<size_t> threads{0};
+        static thread_local const size_t index = threads.fetch_add(1, std::memory_order_relaxed);
+        return shards_[index % TShards];
+    }
+
+    /* adds to the count of the state index, if it is a state */
+    void add(size_t state, int64_t n)
+    {
+        if (state < states)
+            shard().counts[state].fetch_add(n, std::memory_order_relaxed);
+    }
+
+public:
+    /* counts a process entering the state at the index */
+    void enter(size_t state) { add(state, 1); }
+
+    /* counts a process leaving the state at the index */
+    void leave(size_t state) { add(state, -1); }
+
+    /* counts a process moving from one state index to another */
+    void move(size_t from, size_t to)
+    {
+        if (from == to || from >= states || to >= states)
+            return;
+        Shard& counts = shard();
+        counts.counts[from].fetch_sub(1, std::memory_order_relaxed);
+        counts.counts[to].fetch_add(1, std::memory_order_relaxed);
+    }
+
+    /* returns the number of processes in the state at the index */
+    int64_t count(size_t state) const
+    {
+        int64_t n = 0;
+        if (state < states)
+            for (size_t i = 0; i < TShards; ++i)
+                n += shards_[i].counts[state].load(std::memory_order_relaxed);
+        return n;
+    }
+
+    /* returns the number of processes in the state TState */
+    template<typename TState>
+    typename std::enable_if<TypeListContains<typename TMachine::TStateTypes, TState>::value, int64_t>::type count()
+        const
+    {
+        return count(TypeListIndex<typename TMachine::TStateTypes, TState>::index);
+    }
+
+    /* sets counts[i] to the number of processes in the state at index i, for every state */
+    void snapshot(int64_t (&counts)[states]) const
+    {
+        for (size_t s = 0; s < states; ++s)
+            counts[s] = 0;
+        for (size_t i = 0; i < TShards; ++i)
+            for (size_t s = 0; s < states; ++s)
+                counts[s] += shards_[i].counts[s].load(std::memory_order_relaxed);
+    }
+
+    /* sets the threshold of the state TState, noThreshold for none */
+    template<typename TState>
+    typename std::enable_if<TypeListContains<typename TMachine::TStateTypes, TState>::value>::type threshold(int64_t n)
+    {
+        thresholds_[TypeListIndex<typename TMachine::TStateTypes, TState>::index] = n;
+    }
+
+    /* takes a snapshot and calls callback(name, count, over) for each state whose count went to or above its threshold
+     (over is true) or back below it (over is false) since the last check.  returns the number of calls.  not to be
+     called by several threads at once */
+    template<typename TCallback>
+    size_t check(TCallback callback)
+    {
+        int64_t counts[states];
+        snapshot(counts);
+        size_t calls = 0;
+        for (size_t s = 0; s < states; ++s)
+        {
+            const bool over = counts[s] >= thresholds_[s];
+            if (over == over_[s])
+                continue;
+            over_[s] = over;
+            callback(NamedAt<typename TMachine::TStateTypes>::name(s), counts[s], over);
+            ++calls;
+        }
+        return calls;
+    }
+
+    /* sets every count to 0 */
+    void clear()
+    {
+        for (size_t i = 0; i < TShards; ++i)
+            for (size_t s = 0; s < states; ++s)
+                shards_[i].counts[s].store(0, std::memory_order_relaxed);
+    }
+
+    /* writes the name and count of every state, one per line */
+    void dump(std::ostream& os) const
+    {
+        int64_t counts[states];
+        snapshot(counts);
+        for (size_t s = 0; s < states; ++s)
+            os << NamedAt<typename TMachine::TStateTypes>::name(s) << " " << counts[s] << std::endl;
+    }
+
+private:
+    /* the counts, per thread */
+    Shard shards_[TShards];
+    /* the threshold of each state */
+    int64_t thresholds_[states];
+    /* whether each state was at or over its threshold at the last check */
+    bool over_[states];
+};
+
+/* an observer that keeps the counts of an Occupancy up to date for a process, which may be shared by many processes.
+ it remembers the state of its process, so that a start without a reset and the destruction of a process that is in a
+ state are counted right.  a copy starts with no state */
+template<typename TMachine, size_t TShards = 16>
+class OccupancyCounter
+{
+public:
+    OccupancyCounter(Occupancy<TMachine, TShards>& occupancy) : occupancy_(&occupancy), state_(npos) {}
+    OccupancyCounter(const OccupancyCounter& other) : occupancy_(other.occupancy_), state_(npos) {}
+    OccupancyCounter& operator=(const OccupancyCounter&) = delete;
+    ~OccupancyCounter() { occupancy_->leave(state_); }
+
+private:
+    /* no state */
+    static const constexpr size_t npos = TypeListIndexBase::npos;
+
+public:
+    /* counts the process in its begin state, out of the state it was in if it was not reset */
+    template<typename TStateNum>
+    void onStart(const TStateNum& state)
+    {
+        occupancy_->leave(state_);
+        state_ = state.get();
+        occupancy_->enter(state_);
+    }
+
+    /* moves the process to its new state */
+    template<typename TStateNum, typename TEventNum>
+    void onTransition(const TStateNum& from, const TEventNum&, const TStateNum& to)
+    {
+        occupancy_->move(from.get(), to.get());
+        state_ = to.get();
+    }
+
+    /* takes the process out of the state it was in */
+    template<typename TStateNum>
+    void onReset(const TStateNum&)
+    {
+        occupancy_->leave(state_);
+        state_ = npos;
+    }
+
+private:
+    /* where the processes are counted */
+    Occupancy<TMachine, TShards>* occupancy_;
+    /* the state of the process, npos for none */
+    size_t state_;
+};
+
+} // namespace states
@@ -0,0 +1,111 @@
+//
+//  opstorage.hpp
+//  states
+//
+//  Created by Daniel Pav on 10/19/26.
+//  Copyright © 2026 Daniel Pav. All rights reserved.
+//
+
+#pragma once
+
+#include <type_traits>
+
+#include "typelist.hpp"
+
+namespace states
+{
+/* holds the instance of an op with data.  the op is called on the data through the instance */
+template<typename TOp, bool TEmpty = std::is_empty<TOp>::value>
+class OpSlot
+{
+public:
+    /* returns the instance */
+    TOp& get() { return op_; }
+    /* returns the instance */
+    const TOp& get() const { return op_; }
+
+    /* calls the instance on the data */
+    template<typename TData>
+    void call(TData& data)
+    {
+        op_(data);
+    }
+
+private:
+    TOp op_{};
+};
+
+/* an op without data has no instance.  it is constructed for each call, as without storage */
+template<typename TOp>
+class OpSlot<TOp, true>
+{
+public:
+    /* constructs the op and calls it on the data */
+    template<typename TData>
+    constexpr void call(TData& data)
+    {
+        TOp()(data);
+    }
+};
+
+/* a slot for every op in the type list TList.  the slots of ops without data are empty bases and take no space */
+template<typename TList>
+class OpSlots : public OpSlot<typename TList::TCurrentType>, public OpSlots<typename TList::TNextType>
+{
+};
+
+template<>
+class OpSlots<TypeListEnd>
+{
+};
+
+/* one instance of every op of TMachine that has data, constructed once and kept, so that ops may hold buffers, caches
+ or pointers to shared resources instead of keeping them in the data of every process.  ops without data are
+ constructed for each call as before and take no space: the slots are private bases, so the storage of a machine
+ without stateful ops is empty.  the storage is an invoker: give it to a process by value to have it to itself, or
+ share one storage between the processes of a pool with OpStorageRef.  get returns an instance to set it up before use.
+ */
+template<typename TMachine>
+class OpStorage : private OpSlots<typename TMachine::TOpTypes>
+{
+public:
+    /* list of the ops of the machine */
+    using TOpTypes = typename TMachine::TOpTypes;
+
+public:
+    /* returns the instance of the op TOp, which must have data */
+    template<typename TOp>
+    typename std::enable_if<TypeListContains<TOpTypes, TOp>::value && !std::is_empty<TOp>::value, TOp&>::type get()
+    {
+        return static_cast<OpSlot<TOp>&>(*this).get();
+    }
+
+    /* runs the operation TOp of TOwner on the data through the stored instance */
+    template<typename TOwner, typename TOp, typename TData>
+    void invoke(TData& data)
+    {
+        static_cast<OpSlot<TOp>&>(*this).call(data);
+    }
+};
+
+/* an invoker that runs the ops through a storage shared with other processes */
+template<typename TMachine>
+class OpStorageRef
+{
+public:
+    OpStorageRef(OpStorage<TMachine>& storage) : storage_(&storage) {}
+
+public:
+    /* runs the operation TOp of TOwner on the data through the shared storage */
+    template<typename TOwner, typename TOp, typename TData>
+    void invoke(TData& data)
+    {
+        storage_->template invoke<TOwner, TOp>(data);
+    }
+
+private:
+    /* the shared storage */
+    OpStorage<TMachine>* storage_;
+};
+
+} // namespace states
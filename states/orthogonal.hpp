@@ -0,0 +1,240 @@
+//
+//  orthogonal.hpp
+//  states
+//
+//  Created by Daniel Pav on 10/19/26.
+//  Copyright © 2026 Daniel Pav. All rights reserved.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+
+#include "process.hpp"
+#include "typelist.hpp"
+
+namespace states
+{
+/* one region of an orthogonal process: the machine it runs with its begin and end states.  checked like a process */
+template<typename TMachine, typename TBegin, typename TEnd>
+struct Region
+{
+    /* the machine of the region */
+    using TMachineType = TMachine;
+    /* the begin state of the region */
+    using TBeginType = TBegin;
+    /* the end state of the region */
+    using TEndType = TEnd;
+    /* the state num type of the region */
+    using TStateNum = typename TMachine::TStateNum;
+    /* the events handled by the region */
+    using TEventTypes = typename TMachine::TEventTypes;
+
+    /* asserts that the begin state is in the from states */
+    static_assert(TypeListContains<typename TMachine::TFromStateTypes, TBegin>::value, "");
+    /* asserts that the end state is in the to states */
+    static_assert(TypeListContains<typename TMachine::TToStateTypes, TEnd>::value, "");
+    /* make sure the end is reachable from the begin */
+    static_assert(Reachable<TMachine, TBegin, TEnd>::value, "End not reachable from Begin");
+};
+
+/* value is true if any of the regions handles TEvent */
+template<typename TEvent, typename... TRegions>
+struct RegionsHandle;
+
+template<typename TEvent, typename TFirst, typename... TOthers>
+struct RegionsHandle<TEvent, TFirst, TOthers...>
+{
+    static const constexpr bool value =
+        TypeListContains<typename TFirst::TEventTypes, TEvent>::value || RegionsHandle<TEvent, TOthers...>::value;
+};
+
+template<typename TEvent>
+struct RegionsHandle<TEvent>
+{
+    static const constexpr bool value = false;
+};
+
+/* a process made of several regions (see Region) that run side by side on the same data.  the states of all the
+ regions are kept together and are started, reset and checked for validity together.  next<TEvent> is only passed to
+ the regions whose machines have TEvent, which is decided at compile time, and returns true if any region followed a
+ link.  done is true once every region is at its end state.
+ */
+template<typename TData, typename... TRegions>
+class OrthogonalProcess
+{
+public:
+    /* the list of regions */
+    using TRegionList = TypeList<TRegions...>;
+    /* number of regions */
+    static const constexpr size_t regions = sizeof...(TRegions);
+
+    /* creates a process with every region in no-state and storing a reference to the data */
+    OrthogonalProcess(TData& data) : states_(), data_(data) {}
+    /* destroys the process */
+    ~OrthogonalProcess() = default;
+
+private:
+    OrthogonalProcess(const OrthogonalProcess&) = delete;
+    OrthogonalProcess(OrthogonalProcess&&) = delete;
+    OrthogonalProcess& operator=(const OrthogonalProcess&) = delete;
+    OrthogonalProcess& operator=(OrthogonalProcess&&) = delete;
+
+    /* index of a region as a type */
+    template<size_t I>
+    using TIndex = std::integral_constant<size_t, I>;
+
+    /* region at the index */
+    template<size_t I>
+    using TRegionAt = typename TypeListAt<TRegionList, I>::TType;
+
+private:
+    /* region case for reset, clear the state then reset the others */
+    template<size_t I>
+    void resetImpl(TIndex<I>)
+    {
+        std::get<I>(states_).clear();
+        resetImpl(TIndex<I + 1>());
+    }
+
+    /* base case for reset, do nothing */
+    void resetImpl(TIndex<regions>) {}
+
+    /* region case for start, set the begin state and run its op then start the others */
+    template<size_t I>
+    void startImpl(TIndex<I>)
+    {
+        using TRegion = TRegionAt<I>;
+        std::get<I>(states_).template set<typename TRegion::TBeginType>();
+        TRegion::TMachineType::process(std::get<I>(states_), data_);
+        startImpl(TIndex<I + 1>());
+    }
+
+    /* base case for start, do nothing */
+    void startImpl(TIndex<regions>) {}
+
+    /* the region handles the event */
+    template<typename TEvent, size_t I>
+    bool handleImpl(std::true_type)
+    {
+        return TRegionAt<I>::TMachineType::template handle<TEvent>(std::get<I>(states_), data_);
+    }
+
+    /* the region does not have the event, nothing to do */
+    template<typename TEvent, size_t I>
+    bool handleImpl(std::false_type)
+    {
+        return false;
+    }
+
+    /* region case for next, handle in this region if it has the event, then in the others */
+    template<typename TEvent, size_t I>
+    bool nextImpl(TIndex<I>)
+    {
+        using THasEvent = TypeListContains<typename TRegionAt<I>::TEventTypes, TEvent>;
+        const bool handled = handleImpl<TEvent, I>(std::integral_constant<bool, THasEvent::value>());
+        return nextImpl<TEvent>(TIndex<I + 1>()) || handled;
+    }
+
+    /* base case for next, nothing handled */
+    template<typename TEvent>
+    bool nextImpl(TIndex<regions>)
+    {
+        return false;
+    }
+
+    /* region case for invoke, run the op of the current state, then the others.  a region at a state with no links
+     out of it, such as its end state, has no op to run */
+    template<size_t I>
+    void invokeImpl(TIndex<I>)
+    {
+        TRegionAt<I>::TMachineType::process(std::get<I>(states_), data_);
+        invokeImpl(TIndex<I + 1>());
+    }
+
+    /* base case for invoke, do nothing */
+    void invokeImpl(TIndex<regions>) {}
+
+    /* region case for done, at the end state and the others are done */
+    template<size_t I>
+    bool doneImpl(TIndex<I>) const
+    {
+        return std::get<I>(states_).template is<typename TRegionAt<I>::TEndType>() && doneImpl(TIndex<I + 1>());
+    }
+
+    /* base case for done, all done */
+    bool doneImpl(TIndex<regions>) const { return true; }
+
+    /* region case for visit, visit the region as a process then the others */
+    template<typename TVisitor, typename TFirst, typename... TOthers>
+    static void visitImpl(TVisitor& visitor)
+    {
+        Process<typename TFirst::TMachineType, typename TFirst::TBeginType, typename TFirst::TEndType, TData>::visit(
+            visitor);
+        visitImpl<TVisitor, TOthers...>(visitor);
+    }
+
+    /* base case for visit, do nothing */
+    template<typename TVisitor>
+    static void visitImpl(TVisitor& visitor)
+    {
+    }
+
+public:
+    /* sets every region to no-state, equivalent to newly constructed */
+    void reset() { resetImpl(TIndex<0>()); }
+
+    /* sets every region to its begin state, running the state ops in the order of the regions */
+    void start() { startImpl(TIndex<0>()); }
+
+    /* passes the event to the regions that have it, in the order of the regions.  returns true if any of them followed
+     a link */
+    template<typename TEvent>
+    typename std::enable_if<RegionsHandle<TEvent, TRegions...>::value, bool>::type next()
+    {
+        return std::get<0>(states_).valid() ? nextImpl<TEvent>(TIndex<0>()) : false;
+    }
+
+    /* returns true if the region at index I is at the state specified */
+    template<size_t I, typename TState>
+    bool at() const
+    {
+        return std::get<I>(states_).template is<TState>();
+    }
+
+    /* invokes the state op of the current state of every region, returns true if started */
+    bool invoke()
+    {
+        if (!std::get<0>(states_).valid())
+            return false;
+        invokeImpl(TIndex<0>());
+        return true;
+    }
+
+    /* returns true if every region is at its end state */
+    bool done() const { return doneImpl(TIndex<0>()); }
+
+    /* returns the state of the region at index I */
+    template<size_t I>
+    const typename TRegionAt<I>::TStateNum& state() const
+    {
+        return std::get<I>(states_);
+    }
+
+    /* visits each region as a process */
+    template<typename TVisitor>
+    static void visit(TVisitor& visitor)
+    {
+        visitImpl<TVisitor, TRegions...>(visitor);
+    }
+
+private:
+    /* the current state of every region, all invalid if reset */
+    std::tuple<typename TRegions::TStateNum...> states_;
+    /* reference to the data to be operated on during processing */
+    TData& data_;
+};
+
+} // namespace states
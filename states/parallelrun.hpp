@@ -0,0 +1,261 @@
+//
+//  parallelrun.hpp
+//  states
+//
+//  Created by Daniel Pav on 10/19/26.
+//  Copyright © 2026 Daniel Pav. All rights reserved.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+#include "noop.hpp"
+#include "typelist.hpp"
+
+namespace states
+{
+/* classifies a TEventNum as its own index */
+struct EventNumClassifier
+{
+    template<typename TEventNum>
+    size_t operator()(const TEventNum& event) const
+    {
+        return event.get();
+    }
+};
+
+/* runs an op-free machine over a long input on several threads, giving the same result as driving a process with
+ next(TEventNum) for every item in order, ignoring the return value.  the input is split into one chunk per thread.  the
+ first chunk is run from the known start state.  every other chunk is run from every state at once, as a set of lanes
+ that merge once they reach the same state, which they soon do in most recognizers.  the chunks are then stitched in
+ order: the final state of a chunk picks the lane of the next chunk.  each input item is classified into an event
+ index by a classifier (npos for items that are not an event, which are rejected).  the result has the final state,
+ the position of the first event that went into TEnd and the position of the first rejected event (npos for none).
+ */
+template<typename TMachine, typename TBegin, typename TEnd>
+class ParallelRun
+{
+public:
+    /* the state num type of the machine */
+    using TStateNum = typename TMachine::TStateNum;
+    /* the event num type of the machine */
+    using TEventNum = typename TMachine::TEventNum;
+    /* no position */
+    static const constexpr size_t npos = TypeListIndexBase::npos;
+
+    /* the result of a run */
+    struct Result
+    {
+        /* the state after the last item */
+        TStateNum state;
+        /* position of the first item whose event went into TEnd, npos for none */
+        size_t accepted;
+        /* position of the first item that was rejected, npos for none */
+        size_t rejected;
+    };
+
+private:
+    /* asserts that there are no ops to skip */
+    using TOpTypes = typename TMachine::TOpTypes;
+    static_assert(TypeListSize<TOpTypes>::size == 1 && TypeListContains<TOpTypes, NoOp>::value,
+                  "parallel runs are only for machines without ops");
+
+    /* number of states */
+    static const constexpr size_t states = TMachine::stateCount;
+    /* index of the end state */
+    static const constexpr size_t end = TypeListIndex<typename TMachine::TStateTypes, TEnd>::index;
+    /* number of items between attempts to merge lanes */
+    static const constexpr size_t mergeEvery = 16;
+
+    /* the result of a chunk for each state it could start in */
+    struct Chunk
+    {
+        size_t final[states];
+        size_t accepted[states];
+        size_t rejected[states];
+    };
+
+public:
+    /* runs on up to threads threads, giving each at least minChunk items */
+    ParallelRun(size_t threads = std::thread::hardware_concurrency(), size_t minChunk = size_t(1) << 16) :
+        threads_(threads ? threads : 1), minChunk_(minChunk ? minChunk : 1)
+    {
+    }
+
+public:
+    /* runs the events from TBegin */
+    Result run(const TEventNum* events, size_t n) const { return run(begin(), events, n, EventNumClassifier()); }
+
+    /* runs the items from TBegin, classifying them into event indices with classify */
+    template<typename TInput, typename TClassify>
+    Result run(const TInput* input, size_t n, TClassify classify) const
+    {
+        return run(begin(), input, n, classify);
+    }
+
+    /* runs the items from the start state, classifying them into event indices with classify */
+    template<typename TInput, typename TClassify>
+    Result run(const TStateNum& start, const TInput* input, size_t n, TClassify classify) const
+    {
+        Result result{start, npos, npos};
+        if (!start.valid())
+        {
+            /* like a process that was not started, every event is rejected */
+            result.rejected = n ? 0 : npos;
+            return result;
+        }
+        size_t chunks = n / minChunk_;
+        chunks = (chunks < threads_) ? chunks : threads_;
+        if (chunks <= 1)
+        {
+            size_t state = start.get();
+            scanOne(input, 0, n, classify, state, result.accepted, result.rejected);
+            result.state.set(state);
+            return result;
+        }
+        std::vector<Chunk> results(chunks);
+        std::vector<std::thread> workers;
+        workers.reserve(chunks - 1);
+        for (size_t c = 1; c < chunks; ++c)
+            workers.emplace_back(
+                [&, c]() { scanAll(input, c * n / chunks, (c + 1) * n / chunks, classify, results[c]); });
+        size_t state = start.get();
+        scanOne(input, 0, n / chunks, classify, state, result.accepted, result.rejected);
+        for (std::thread& worker : workers)
+            worker.join();
+        for (size_t c = 1; c < chunks; ++c)
+        {
+            const Chunk& chunk = results[c];
+            if (result.accepted == npos)
+                result.accepted = chunk.accepted[state];
+            if (result.rejected == npos)
+                result.rejected = chunk.rejected[state];
+            state = chunk.final[state];
+        }
+        result.state.set(state);
+        return result;
+    }
+
+private:
+    static TStateNum begin()
+    {
+        TStateNum state;
+        state.template set<TBegin>();
+        return state;
+    }
+
+    /* runs the items [from, to) from a single known state */
+    template<typename TInput, typename TClassify>
+    static void scanOne(const TInput* input, size_t from, size_t to, TClassify& classify, size_t& state,
+                        size_t& accepted, size_t& rejected)
+    {
+        for (size_t i = from; i != to; ++i)
+        {
+            const size_t next = TMachine::target(state, classify(input[i]));
+            if (next == npos)
+            {
+                if (rejected == npos)
+                    rejected = i;
+                continue;
+            }
+            state = next;
+            if (state == end && accepted == npos)
+                accepted = i;
+        }
+    }
+
+    /* runs the items [from, to) from every state.  a lane is the state reached from one or more start states, its
+     members, which are kept as a linked list.  a lane is pending while any member has no accepted or rejected
+     position */
+    template<typename TInput, typename TClassify>
+    static void scanAll(const TInput* input, size_t from, size_t to, TClassify& classify, Chunk& chunk)
+    {
+        size_t laneState[states];
+        size_t laneHead[states];
+        size_t laneTail[states];
+        bool acceptPending[states];
+        bool rejectPending[states];
+        size_t memberNext[states];
+        size_t lanes = states;
+        for (size_t s = 0; s < states; ++s)
+        {
+            laneState[s] = s;
+            laneHead[s] = s;
+            laneTail[s] = s;
+            acceptPending[s] = true;
+            rejectPending[s] = true;
+            memberNext[s] = npos;
+            chunk.accepted[s] = npos;
+            chunk.rejected[s] = npos;
+        }
+        for (size_t i = from; i != to; ++i)
+        {
+            const size_t event = classify(input[i]);
+            for (size_t l = 0; l < lanes; ++l)
+            {
+                const size_t next = TMachine::target(laneState[l], event);
+                if (next == npos)
+                {
+                    if (rejectPending[l])
+                    {
+                        for (size_t m = laneHead[l]; m != npos; m = memberNext[m])
+                            if (chunk.rejected[m] == npos)
+                                chunk.rejected[m] = i;
+                        rejectPending[l] = false;
+                    }
+                    continue;
+                }
+                laneState[l] = next;
+                if (next == end && acceptPending[l])
+                {
+                    for (size_t m = laneHead[l]; m != npos; m = memberNext[m])
+                        if (chunk.accepted[m] == npos)
+                            chunk.accepted[m] = i;
+                    acceptPending[l] = false;
+                }
+            }
+            if (lanes > 1 && (i - from) % mergeEvery == mergeEvery - 1)
+            {
+                /* lanes in the same state will stay together, keep the first and move the members of the others */
+                size_t owner[states];
+                for (size_t s = 0; s < states; ++s)
+                    owner[s] = npos;
+                size_t kept = 0;
+                for (size_t l = 0; l < lanes; ++l)
+                {
+                    const size_t o = owner[laneState[l]];
+                    if (o == npos)
+                    {
+                        owner[laneState[l]] = kept;
+                        laneState[kept] = laneState[l];
+                        laneHead[kept] = laneHead[l];
+                        laneTail[kept] = laneTail[l];
+                        acceptPending[kept] = acceptPending[l];
+                        rejectPending[kept] = rejectPending[l];
+                        ++kept;
+                        continue;
+                    }
+                    memberNext[laneTail[o]] = laneHead[l];
+                    laneTail[o] = laneTail[l];
+                    acceptPending[o] = acceptPending[o] || acceptPending[l];
+                    rejectPending[o] = rejectPending[o] || rejectPending[l];
+                }
+                lanes = kept;
+            }
+        }
+        for (size_t l = 0; l < lanes; ++l)
+            for (size_t m = laneHead[l]; m != npos; m = memberNext[m])
+                chunk.final[m] = laneState[l];
+    }
+
+private:
+    /* most threads used */
+    size_t threads_;
+    /* fewest items given to a thread */
+    size_t minChunk_;
+};
+
+} // namespace states
@@ -8,9 +8,16 @@
 
 #pragma once
 
+#include <cstddef>
 #include <type_traits>
+#if (defined(_MSVC_LANG) && _MSVC_LANG >= 202002L) || __cplusplus >= 202002L
+#include <span>
+#endif
 
+#include "invoker.hpp"
+#include "observer.hpp"
 #include "typelist.hpp"
+#include "wildcard.hpp"
 
 namespace states
 {
@@ -18,11 +25,12 @@ namespace states
 template<typename TMachine, typename TBegin, typename TEnd>
 struct Reachable;
 
-/* determines if the link goes from begin to end.  if so, value is true */
+/* determines if the link goes from begin to end.  if so, value is true.  a link from any state goes from begin */
 template<typename TBegin, typename TEnd, typename TLink>
 struct Match
 {
-    using TSameBegin = std::is_same<TBegin, typename TLink::TFromType>;
+    using TSameBegin = std::integral_constant<bool, std::is_same<TBegin, typename TLink::TFromType>::value ||
+                                                        std::is_same<AnyState, typename TLink::TFromType>::value>;
     using TSameEnd = std::is_same<TEnd, typename TLink::TToType>;
     static const constexpr bool value = TSameBegin::value && TSameEnd::value;
 };
@@ -86,15 +94,20 @@ struct Reachable
  calling reset.  This sets the process back to the newly constructed state.  Or start can be called again to return to
  the start state. [It is not necessary to call reset before calling start.] Start is not called automaticly because
  start may invoke an operation on the data given and did not want this to be an issue when the data being passed is a
- reference to an owning object.
+ reference to an owning object.  TObserver is told about every start, transition and reset (see NoObserver), TInvoker runs every
+ link and state op (see DirectInvoker).  Both are held by the process and take no space when they have no data.
  */
-template<typename TMachine, typename TBegin, typename TEnd, typename TData>
-class Process
+template<typename TMachine, typename TBegin, typename TEnd, typename TData, typename TObserver = NoObserver,
+         typename TInvoker = DirectInvoker>
+class Process : private TObserver, private TInvoker
 {
 public:
     /* creates a process setting the internal state to invalid (equivalent to reset) and storing a reference to the data
      */
-    Process(TData& data) : state_(), data_(data) {}
+    constexpr Process(TData& data, const TObserver& observer = TObserver(), const TInvoker& invoker = TInvoker()) :
+        TObserver(observer), TInvoker(invoker), state_(), data_(data)
+    {
+    }
     /* destroys the process */
     ~Process() = default;
 
@@ -105,6 +118,14 @@ private:
     Process& operator=(Process&&) = delete;
 
 public:
+    /* the machine */
+    using TMachineType = TMachine;
+    /* the begin state */
+    using TBeginType = TBegin;
+    /* the end state */
+    using TEndType = TEnd;
+    /* the data */
+    using TDataType = TData;
     /* the state num type using the states form the machine given */
     using TStateNum = typename TMachine::TStateNum;
     /* the event num type using the events from the machine given */
@@ -118,37 +139,151 @@ public:
     
 public:
     /* sets the process to no-state, equivalent to newly constructed */
-    void reset() { state_.clear(); }
+    constexpr void reset()
+    {
+        observer().onReset(state_);
+        state_.clear();
+    }
 
     /* sets the state to the TBegin state */
-    void start()
+    constexpr void start()
     {
         state_.template set<TBegin>();
-        TMachine::process(state_, data_);
+        TMachine::process(state_, data_, invoker());
+        observer().onStart(state_);
     }
 
     /* processes the event given, calling the link op, then the state op, returns true if link exists */
-    bool next(const TEventNum& event) { return state_.valid() ? TMachine::handle(state_, event, data_) : false; }
+    constexpr bool next(const TEventNum& event) { return next(event, invoker()); }
+
+    /* processes the event given like next, running the ops through the invoker given instead of the process's own */
+    template<typename TOtherInvoker>
+    constexpr bool next(const TEventNum& event, TOtherInvoker& other)
+    {
+        if (!state_.valid())
+            return false;
+        const TStateNum from = state_;
+        if (!TMachine::handle(state_, event, data_, other))
+            return false;
+        observer().onTransition(from, event, state_);
+        return true;
+    }
 
     /* processes the event given, calling the link op, then the state op, returns true if link exists */
     template<typename TEvent>
-    bool next()
+    constexpr bool next()
+    {
+        if (!state_.valid())
+            return false;
+        const TStateNum from = state_;
+        if (!TMachine::template handle<TEvent>(state_, data_, invoker()))
+            return false;
+        TEventNum event{};
+        event.template set<TEvent>();
+        observer().onTransition(from, event, state_);
+        return true;
+    }
+
+    /* processes the n events given in order, as next does for each, with the state held in a local for the whole batch
+     so it can stay in a register.  stops at the first event next would reject, that is without a link from the state,
+     so TEnd only stops the batch if it has no links.  returns the number of events processed, 0 if at no state.  ops
+     and the observer must not look at this process during the batch */
+    constexpr size_t next(const TEventNum* events, size_t n)
+    {
+        TStateNum state = state_;
+        size_t i = 0;
+        if (state.valid())
+            for (; i < n; ++i)
+            {
+                const TStateNum from = state;
+                if (!TMachine::handle(state, events[i], data_, invoker()))
+                    break;
+                observer().onTransition(from, events[i], state);
+            }
+        state_ = state;
+        return i;
+    }
+
+#if (defined(_MSVC_LANG) && _MSVC_LANG >= 202002L) || __cplusplus >= 202002L
+    /* processes the events in the span as next(events, n) */
+    constexpr size_t next(std::span<const TEventNum> events) { return next(events.data(), events.size()); }
+#endif
+
+    /* processes the events TFirst, TSecond, TOthers... in order as next(events, n), with each handled by its type.
+     returns the number of events processed */
+    template<typename TFirst, typename TSecond, typename... TOthers>
+    constexpr size_t next()
+    {
+        TStateNum state = state_;
+        const size_t n = state.valid()
+            ? nextImpl(state, 0, static_cast<const TypeList<TFirst, TSecond, TOthers...>*>(nullptr))
+            : 0;
+        state_ = state;
+        return n;
+    }
+
+private:
+    /* event case for the typed batch, handles the first event and if it has a link the others.  returns the number of
+     events processed in all */
+    template<typename TList>
+    constexpr size_t nextImpl(TStateNum& state, size_t n, const TList*)
     {
-        return state_.valid() ? TMachine::template handle<TEvent>(state_, data_) : false;
+        using TEvent = typename TList::TCurrentType;
+        const TStateNum from = state;
+        if (!TMachine::template handle<TEvent>(state, data_, invoker()))
+            return n;
+        TEventNum event{};
+        event.template set<TEvent>();
+        observer().onTransition(from, event, state);
+        return nextImpl(state, n + 1, static_cast<const typename TList::TNextType*>(nullptr));
     }
 
+    /* base case for the typed batch, no events left */
+    constexpr size_t nextImpl(TStateNum&, size_t n, const TypeListEnd*) { return n; }
+
+public:
+
     /* returns true if at the state specified */
     template<typename TState>
-    bool at() const
+    constexpr bool at() const
     {
         return state_.template is<TState>();
     }
 
+    /* returns true if the current state has a link for the event, without following it */
+    constexpr bool accepts(const TEventNum& event) const { return TMachine::accepts(state_, event); }
+
+    /* returns true if the current state has a link for the event TEvent, without following it */
+    template<typename TEvent>
+    constexpr bool accepts() const
+    {
+        TEventNum event{};
+        event.template set<TEvent>();
+        return accepts(event);
+    }
+
+    /* returns the set of events the current state has links for, one bit per event index of TEventNum.  empty if there
+     is no current state */
+    constexpr const typename TMachine::TEventMask& acceptedEvents() const { return TMachine::accepted(state_); }
+
     /* invokes the state op for the current state, returns true if at a state */
-    bool invoke() { return state_.valid() ? TMachine::process(state_, data_) : false; }
+    constexpr bool invoke() { return state_.valid() ? TMachine::process(state_, data_, invoker()) : false; }
 
     /* returns true if at the TEnd state, equivalent to at<TEnd>() */
-    bool done() const { return state_.template is<TEnd>(); }
+    constexpr bool done() const { return state_.template is<TEnd>(); }
+
+    /* returns the current state, not valid if reset */
+    constexpr const TStateNum& state() const { return state_; }
+
+    /* returns the observer */
+    constexpr TObserver& observer() { return *this; }
+    /* returns the observer */
+    constexpr const TObserver& observer() const { return *this; }
+
+    /* returns the invoker */
+    constexpr TInvoker& invoker() { return *this; }
+    /* returns the invoker */
+    constexpr const TInvoker& invoker() const { return *this; }
 
     /* visits the process by visiting its machine and its begin and end states */
     template<typename TVisitor>
@@ -0,0 +1,235 @@
+//
+//  processslab.hpp
+//  states
+//
+//  Created by Daniel Pav on 10/19/26.
+//  Copyright © 2026 Daniel Pav. All rights reserved.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace states
+{
+/* a 32 bit handle to a slot of a ProcessSlab: the index of the slot in the low TIndexBits bits and the generation of
+ the slot above it.  a generation is never 0, so the handle 0 is not valid */
+template<unsigned TIndexBits>
+class SlabHandle
+{
+public:
+    static_assert(TIndexBits > 0 && TIndexBits < 32, "a handle needs bits for the index and the generation");
+
+    /* bits of the index */
+    static const constexpr unsigned indexBits = TIndexBits;
+    /* mask of the index */
+    static const constexpr uint32_t indexMask = (uint32_t(1) << TIndexBits) - 1;
+    /* largest generation */
+    static const constexpr uint32_t maxGeneration = uint32_t(0xffffffffu) >> TIndexBits;
+
+    SlabHandle() = default;
+    SlabHandle(uint32_t index, uint32_t generation) : value_((generation << TIndexBits) | index) {}
+
+public:
+    /* returns true if the handle was returned by a successful acquire */
+    bool valid() const { return generation() != 0; }
+    /* returns the slot */
+    uint32_t index() const { return value_ & indexMask; }
+    /* returns the generation of the slot when it was acquired */
+    uint32_t generation() const { return value_ >> TIndexBits; }
+    /* returns the handle as a number, to store or send it */
+    uint32_t value() const { return value_; }
+    /* returns the handle from a number returned by value */
+    static SlabHandle fromValue(uint32_t value)
+    {
+        SlabHandle handle;
+        handle.value_ = value;
+        return handle;
+    }
+
+    bool operator==(const SlabHandle& other) const { return value_ == other.value_; }
+    bool operator!=(const SlabHandle& other) const { return value_ != other.value_; }
+
+private:
+    uint32_t value_{0};
+};
+
+/* a fixed number of processes of type TProcess with their data, allocated together when the slab is created.  acquire
+ takes a free slot, resets and starts its process and returns a handle to it.  release resets the process and gives the
+ slot back with a new generation, so the handles to it are no longer valid.  a slot whose generation reaches the largest
+ a handle holds is retired instead of given back, so that an old handle can never match it again; with the default 20
+ index bits that is after 4095 uses of the slot.  slots are reused without being destroyed: a process and
+ its data are constructed once, and a reused process is only reset and started, so the slab does not use the heap after
+ it is created.  the data is constructed once too; set it up in the init given to acquire, or in the op of the begin
+ state.  if recycle is true, next releases the slot when the process reaches its end state, so a session that is done
+ gives its slot back without a call to release.
+ */
+template<typename TProcess, unsigned TIndexBits = 20>
+class ProcessSlab
+{
+public:
+    /* the handle type */
+    using THandle = SlabHandle<TIndexBits>;
+    /* the data of the processes */
+    using TData = typename TProcess::TDataType;
+    /* the event num type of the processes */
+    using TEventNum = typename TProcess::TEventNum;
+
+private:
+    /* a process, its data and its place in the free list */
+    struct Slot
+    {
+        Slot() : data(), process(data) {}
+
+        TData data;
+        TProcess process;
+        uint32_t generation{1};
+        uint32_t next{0};
+        bool used{false};
+    };
+
+    /* no slot */
+    static const constexpr uint32_t none = THandle::indexMask;
+
+public:
+    /* creates the slots, at most one less than the number of indices */
+    ProcessSlab(size_t capacity, bool recycle = false) :
+        slots_((capacity < none) ? capacity : none), free_(none), size_(0), recycle_(recycle)
+    {
+        for (size_t i = slots_.size(); i-- > 0;)
+        {
+            slots_[i].next = free_;
+            free_ = static_cast<uint32_t>(i);
+        }
+    }
+
+private:
+    ProcessSlab(const ProcessSlab&) = delete;
+    ProcessSlab& operator=(const ProcessSlab&) = delete;
+
+    /* does nothing to the data */
+    struct NoInit
+    {
+        void operator()(TData&) const {}
+    };
+
+    /* returns the slot if the handle is to it, nullptr if not */
+    Slot* find(const THandle& handle)
+    {
+        if (!handle.valid() || handle.index() >= slots_.size())
+            return nullptr;
+        Slot& slot = slots_[handle.index()];
+        return (slot.used && slot.generation == handle.generation()) ? &slot : nullptr;
+    }
+
+    /* releases the slot, making its handles invalid, and retires it if it has used its last generation */
+    void release(Slot& slot, uint32_t index)
+    {
+        slot.used = false;
+        slot.process.reset();
+        --size_;
+        if (slot.generation == THandle::maxGeneration)
+        {
+            ++retired_;
+            return;
+        }
+        ++slot.generation;
+        slot.next = free_;
+        free_ = index;
+    }
+
+    /* releases the slot after a transition if recycling and the process is done */
+    bool after(Slot& slot, const THandle& handle, bool handled)
+    {
+        if (handled && recycle_ && slot.process.done())
+            release(slot, handle.index());
+        return handled;
+    }
+
+public:
+    /* takes a free slot, resets and starts its process.  returns an invalid handle if there is no free slot */
+    THandle acquire() { return acquire(NoInit()); }
+
+    /* takes a free slot like acquire, calling init on the data after the reset and before the start */
+    template<typename TInit>
+    THandle acquire(TInit init)
+    {
+        if (free_ == none)
+            return THandle();
+        const uint32_t index = free_;
+        Slot& slot = slots_[index];
+        free_ = slot.next;
+        slot.used = true;
+        ++size_;
+        slot.process.reset();
+        init(slot.data);
+        slot.process.start();
+        return THandle(index, slot.generation);
+    }
+
+    /* gives the slot back, returns false if the handle is not valid */
+    bool release(const THandle& handle)
+    {
+        Slot* slot = find(handle);
+        if (!slot)
+            return false;
+        release(*slot, handle.index());
+        return true;
+    }
+
+    /* returns true if the handle is to a slot in use */
+    bool valid(const THandle& handle) { return find(handle) != nullptr; }
+
+    /* returns the process of the handle, nullptr if the handle is not valid */
+    TProcess* get(const THandle& handle)
+    {
+        Slot* slot = find(handle);
+        return slot ? &slot->process : nullptr;
+    }
+
+    /* returns the data of the handle, nullptr if the handle is not valid */
+    TData* data(const THandle& handle)
+    {
+        Slot* slot = find(handle);
+        return slot ? &slot->data : nullptr;
+    }
+
+    /* passes the event to the process of the handle.  returns false if the handle is not valid or the event was not
+     handled */
+    template<typename TEvent>
+    bool next(const THandle& handle)
+    {
+        Slot* slot = find(handle);
+        return slot ? after(*slot, handle, slot->process.template next<TEvent>()) : false;
+    }
+
+    /* passes the event to the process of the handle, as above */
+    bool next(const THandle& handle, const TEventNum& event)
+    {
+        Slot* slot = find(handle);
+        return slot ? after(*slot, handle, slot->process.next(event)) : false;
+    }
+
+    /* returns the number of slots in use */
+    size_t size() const { return size_; }
+    /* returns the number of slots */
+    size_t capacity() const { return slots_.size(); }
+    /* returns the number of slots retired after their last generation */
+    size_t retired() const { return retired_; }
+
+private:
+    /* the slots, never resized */
+    std::vector<Slot> slots_;
+    /* first free slot */
+    uint32_t free_;
+    /* slots in use */
+    size_t size_;
+    /* slots never given out again */
+    size_t retired_{0};
+    /* release slots whose process is done after next */
+    bool recycle_;
+};
+
+} // namespace states
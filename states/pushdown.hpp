@@ -0,0 +1,305 @@
+//
+//  pushdown.hpp
+//  states
+//
+//  Created by Daniel Pav on 10/19/26.
+//  Copyright © 2026 Daniel Pav. All rights reserved.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#include "invoker.hpp"
+#include "link.hpp"
+#include "noop.hpp"
+#include "observer.hpp"
+#include "process.hpp"
+#include "state.hpp"
+#include "typelist.hpp"
+
+namespace states
+{
+/* the name of the return state */
+template<typename T = void>
+struct ReturnName
+{
+    static const char name[];
+};
+
+template<typename T>
+const char ReturnName<T>::name[] = "return";
+
+/* the state a return link goes to.  a PushdownProcess never stays in it: it goes on to the state on top of its stack */
+using ReturnState = State<ReturnName<>::name>;
+
+/* a link from TFrom to TTo on TEvent that, in a PushdownProcess, pushes TReturn to be returned to by a return link */
+template<typename TFrom, typename TEvent, typename TTo, typename TReturn, typename TLinkOp = NoOp>
+class CallLink : public Link<TFrom, TEvent, TTo, TLinkOp>
+{
+public:
+    /* the state returned to */
+    using TReturnType = TReturn;
+};
+
+/* a link from TFrom on TEvent that, in a PushdownProcess, pops the state on top of the stack and goes to it */
+template<typename TFrom, typename TEvent, typename TLinkOp = NoOp>
+using ReturnLink = Link<TFrom, TEvent, ReturnState, TLinkOp>;
+
+/* the index in TStateTypes of the state the link TLink pushes, npos for a link that is not a call */
+template<typename TStateTypes, typename TLink>
+struct PushOf
+{
+    static const constexpr size_t index = TypeListIndexBase::npos;
+};
+
+template<typename TStateTypes, typename TFrom, typename TEvent, typename TTo, typename TReturn, typename TLinkOp>
+struct PushOf<TStateTypes, CallLink<TFrom, TEvent, TTo, TReturn, TLinkOp>>
+{
+    static const constexpr size_t index = TypeListIndex<TStateTypes, TReturn>::index;
+};
+
+/* the way a call link TLink gives, for reachability, over the states it calls to the state it returns to: from its
+ from state straight to TReturn.  any other link gives itself */
+template<typename TLink>
+struct CallReturnLink
+{
+    using TType = TLink;
+};
+
+template<typename TFrom, typename TEvent, typename TTo, typename TReturn, typename TLinkOp>
+struct CallReturnLink<CallLink<TFrom, TEvent, TTo, TReturn, TLinkOp>>
+{
+    struct TType
+    {
+        using TFromType = TFrom;
+        using TToType = TReturn;
+    };
+};
+
+/* the links of a machine as seen by PushdownReachable: every link, and for each call link its way to its return */
+template<typename TLinkList>
+struct PushdownLinks;
+
+template<typename... TLinks>
+struct PushdownLinks<TypeList<TLinks...>>
+{
+    using TLinkList = TypeList<TLinks..., typename CallReturnLink<TLinks>::TType...>;
+};
+
+/* value is whether TEnd is reachable from TBegin using TMachine in a PushdownProcess.  as for Reachable, but a call
+ link also reaches the state it returns to, since the states called return to it through ReturnState */
+template<typename TMachine, typename TBegin, typename TEnd>
+struct PushdownReachable
+{
+    static const constexpr bool value = Reachable<PushdownLinks<typename TMachine::TLinkList>, TBegin, TEnd>::value;
+};
+
+/* overflow policy: a call on a full stack is rejected, the process stays where it is and next returns false */
+struct OverflowReject
+{
+};
+
+/* overflow policy: a call on a full stack resets the process, as reset does, and next returns false */
+struct OverflowReset
+{
+};
+
+/* a process like Process whose machine can call and return: a CallLink pushes its return state on a stack held in the
+ process and a ReturnLink pops it and goes to it, running its state op, so a nested format can be parsed by one set of
+ states used at every depth.  the stack holds at most TDepth states and takes no allocation.  a call when it is full is
+ handled by TOverflow (OverflowReject or OverflowReset) and a return when it is empty is rejected.  the process is done
+ at TEnd, whatever the depth.  the observer is told of a return as a transition to the state returned to.
+ */
+template<typename TMachine, typename TBegin, typename TEnd, typename TData, size_t TDepth,
+         typename TOverflow = OverflowReject, typename TObserver = NoObserver, typename TInvoker = DirectInvoker>
+class PushdownProcess : private TObserver, private TInvoker
+{
+public:
+    /* creates a process with no state and an empty stack, storing a reference to the data */
+    PushdownProcess(TData& data, const TObserver& observer = TObserver(), const TInvoker& invoker = TInvoker()) :
+        TObserver(observer), TInvoker(invoker), state_(), depth_(0), data_(data)
+    {
+    }
+
+private:
+    PushdownProcess(const PushdownProcess&) = delete;
+    PushdownProcess& operator=(const PushdownProcess&) = delete;
+
+public:
+    /* the machine */
+    using TMachineType = TMachine;
+    /* the begin state */
+    using TBeginType = TBegin;
+    /* the end state */
+    using TEndType = TEnd;
+    /* the data */
+    using TDataType = TData;
+    /* the state num type using the states form the machine given */
+    using TStateNum = typename TMachine::TStateNum;
+    /* the event num type using the events from the machine given */
+    using TEventNum = typename TMachine::TEventNum;
+    /* the most states on the stack */
+    static const constexpr size_t maxDepth = TDepth;
+    /* asserts that the stack can hold a state */
+    static_assert(TDepth > 0, "the stack must hold at least one state");
+    /* asserts that the begin state is in the from states */
+    static_assert(TypeListContains<typename TMachine::TFromStateTypes, TBegin>::value, "");
+    /* asserts that the end state is in the to states */
+    static_assert(TypeListContains<typename TMachine::TToStateTypes, TEnd>::value, "");
+    /* make sure the end is reachable from the begin */
+    static_assert(PushdownReachable<TMachine, TBegin, TEnd>::value, "End not reachable from Begin");
+
+private:
+    /* no state */
+    static const constexpr size_t npos = TypeListIndexBase::npos;
+    /* the index of the return state, npos if the machine has no return links */
+    static const constexpr size_t returnState = TypeListIndex<typename TMachine::TStateTypes, ReturnState>::index;
+    /* the smallest type that holds a state index */
+    using TEntry = typename std::conditional<
+        (TMachine::stateCount < 0x100), uint8_t,
+        typename std::conditional<(TMachine::stateCount < 0x10000), uint16_t, uint32_t>::type>::type;
+
+    /* link case for the state pushed by the link index, the first link's if it is the one, else the others' */
+    template<typename TList>
+    static constexpr size_t pushImpl(size_t link, size_t index, const TList*)
+    {
+        return (link == index)
+            ? PushOf<typename TMachine::TStateTypes, typename TList::TCurrentType>::index
+            : pushImpl(link, index + 1, static_cast<const typename TList::TNextType*>(nullptr));
+    }
+
+    /* base case for the state pushed, no link */
+    static constexpr size_t pushImpl(size_t, size_t, const TypeListEnd*) { return npos; }
+
+    /* returns the index of the state pushed by the link index, npos if it is not a call */
+    static constexpr size_t push(size_t link)
+    {
+        return pushImpl(link, 0, static_cast<const typename TMachine::TLinkList*>(nullptr));
+    }
+
+    /* a call on a full stack is rejected */
+    bool overflow(OverflowReject) { return false; }
+
+    /* a call on a full stack resets the process */
+    bool overflow(OverflowReset)
+    {
+        reset();
+        return false;
+    }
+
+public:
+    /* sets the process to no-state with an empty stack, equivalent to newly constructed */
+    void reset()
+    {
+        observer().onReset(state_);
+        state_.clear();
+        depth_ = 0;
+    }
+
+    /* sets the state to the TBegin state with an empty stack */
+    void start()
+    {
+        depth_ = 0;
+        state_.template set<TBegin>();
+        TMachine::process(state_, data_, invoker());
+        observer().onStart(state_);
+    }
+
+    /* processes the event given, returns true if there is a link for it that was followed */
+    bool next(const TEventNum& event) { return next(event, invoker()); }
+
+    /* processes the event given like next, running the ops through the invoker given instead of the process's own */
+    template<typename TOtherInvoker>
+    bool next(const TEventNum& event, TOtherInvoker& other)
+    {
+        if (!state_.valid())
+            return false;
+        const size_t link = TMachine::link(state_.get(), event.get());
+        if (link == npos)
+            return false;
+        const size_t pushed = push(link);
+        const bool pop = (TMachine::target(state_.get(), event.get()) == returnState);
+        if (pop && depth_ == 0 && pushed == npos)
+            return false;
+        if (pushed != npos && depth_ == TDepth)
+            return overflow(TOverflow());
+        const TStateNum from = state_;
+        TMachine::handle(state_, event, data_, other);
+        if (pushed != npos)
+            stack_[depth_++] = static_cast<TEntry>(pushed);
+        if (pop)
+        {
+            state_.set(stack_[--depth_]);
+            TMachine::process(state_, data_, other);
+        }
+        observer().onTransition(from, event, state_);
+        return true;
+    }
+
+    /* processes the event TEvent as next */
+    template<typename TEvent>
+    typename std::enable_if<TypeListContains<typename TMachine::TEventTypes, TEvent>::value, bool>::type next()
+    {
+        TEventNum event{};
+        event.template set<TEvent>();
+        return next(event);
+    }
+
+    /* returns true if at the state specified */
+    template<typename TState>
+    bool at() const
+    {
+        return state_.template is<TState>();
+    }
+
+    /* returns true if the current state has a link for the event, without following it */
+    bool accepts(const TEventNum& event) const { return TMachine::accepts(state_, event); }
+
+    /* invokes the state op for the current state, returns true if at a state */
+    bool invoke() { return state_.valid() ? TMachine::process(state_, data_, invoker()) : false; }
+
+    /* returns true if at the TEnd state */
+    bool done() const { return state_.template is<TEnd>(); }
+
+    /* returns the current state, not valid if reset */
+    const TStateNum& state() const { return state_; }
+
+    /* returns the number of states on the stack */
+    size_t depth() const { return depth_; }
+
+    /* returns the observer */
+    TObserver& observer() { return *this; }
+    /* returns the observer */
+    const TObserver& observer() const { return *this; }
+
+    /* returns the invoker */
+    TInvoker& invoker() { return *this; }
+    /* returns the invoker */
+    const TInvoker& invoker() const { return *this; }
+
+    /* visits the process by visiting its machine and its begin and end states */
+    template<typename TVisitor>
+    static void visit(TVisitor& visitor)
+    {
+        visitor.preProcess();
+        visitor.visitBegin(TBegin::name());
+        TMachine::visit(visitor);
+        visitor.visitEnd(TEnd::name());
+        visitor.postProcess();
+    }
+
+private:
+    /* the current state, may be invalid if reset */
+    TStateNum state_;
+    /* the number of states on the stack */
+    size_t depth_;
+    /* the states to return to, the last on top */
+    TEntry stack_[TDepth];
+    /* reference to the data to be operated on during processing */
+    TData& data_;
+};
+
+} // namespace states
@@ -0,0 +1,202 @@
+//
+//  sharedstates.cpp
+//  states
+//
+//  Created by Daniel Pav on 10/19/26.
+//  Copyright © 2026 Daniel Pav. All rights reserved.
+//
+
+#include "sharedstates.hpp"
+
+#if defined(__unix__) || defined(__APPLE__)
+
+#include <cstring>
+#include <fcntl.h>
+#include <new>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace states
+{
+static_assert(ATOMIC_INT_LOCK_FREE == 2, "the slots need lock free 32 bit atomics to be shared between processes");
+static_assert(sizeof(SharedSlot) == 64, "a slot fills a cache line");
+
+namespace
+{
+/* the magic at the start of a segment */
+const char magic[8] = {'S', 'T', 'A', 'T', 'E', 'S', 'H', 'M'};
+
+/* returns the size rounded up to a cache line */
+size_t roundUp(size_t size) { return (size + 63) & ~static_cast<size_t>(63); }
+} // namespace
+
+bool SharedStateSegment::create(const std::string& name, uint32_t slots, const char* const* stateNames,
+                                uint32_t states, const char* const* eventNames, uint32_t events)
+{
+    close();
+    size_t names = 0;
+    for (uint32_t s = 0; s < states; ++s)
+        names += std::strlen(stateNames[s]) + 1;
+    for (uint32_t e = 0; e < events; ++e)
+        names += std::strlen(eventNames[e]) + 1;
+    const size_t namesOffset = roundUp(sizeof(SharedHeader));
+    const size_t slotsOffset = roundUp(namesOffset + names);
+    const size_t size = slotsOffset + sizeof(SharedSlot) * slots;
+    if (slotsOffset > 0xffffffffu)
+        return false;
+    const int fd = ::shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+    if (fd < 0)
+        return false;
+    void* base = (::ftruncate(fd, static_cast<off_t>(size)) == 0)
+        ? ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0)
+        : MAP_FAILED;
+    ::close(fd);
+    if (base == MAP_FAILED)
+    {
+        ::shm_unlink(name.c_str());
+        return false;
+    }
+    name_ = name;
+    base_ = base;
+    size_ = size;
+    owner_ = true;
+    char* bytes = static_cast<char*>(base);
+    header_ = new (bytes) SharedHeader();
+    std::memcpy(header_->magic, magic, sizeof(magic));
+    header_->version = version;
+    header_->slots = slots;
+    header_->states = states;
+    header_->events = events;
+    header_->namesOffset = static_cast<uint32_t>(namesOffset);
+    header_->slotsOffset = static_cast<uint32_t>(slotsOffset);
+    char* out = bytes + namesOffset;
+    for (uint32_t s = 0; s < states; ++s)
+        out = std::strcpy(out, stateNames[s]) + std::strlen(stateNames[s]) + 1;
+    for (uint32_t e = 0; e < events; ++e)
+        out = std::strcpy(out, eventNames[e]) + std::strlen(eventNames[e]) + 1;
+    slots_ = reinterpret_cast<SharedSlot*>(bytes + slotsOffset);
+    for (uint32_t i = 0; i < slots; ++i)
+    {
+        SharedSlot* slot = new (&slots_[i]) SharedSlot();
+        slot->sequence.store(0, std::memory_order_relaxed);
+        slot->state.store(SharedSlot::none, std::memory_order_relaxed);
+        slot->event.store(SharedSlot::none, std::memory_order_relaxed);
+        slot->transitions.store(0, std::memory_order_relaxed);
+    }
+    header_->ready.store(1, std::memory_order_release);
+    return true;
+}
+
+bool SharedStateSegment::open(const std::string& name)
+{
+    close();
+    const int fd = ::shm_open(name.c_str(), O_RDONLY, 0);
+    if (fd < 0)
+        return false;
+    struct stat info;
+    void* base = (::fstat(fd, &info) == 0 && static_cast<size_t>(info.st_size) >= sizeof(SharedHeader))
+        ? ::mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_SHARED, fd, 0)
+        : MAP_FAILED;
+    ::close(fd);
+    if (base == MAP_FAILED)
+        return false;
+    base_ = base;
+    size_ = static_cast<size_t>(info.st_size);
+    header_ = static_cast<SharedHeader*>(base);
+    const bool valid = header_->ready.load(std::memory_order_acquire) == 1 &&
+        std::memcmp(header_->magic, magic, sizeof(magic)) == 0 && header_->version == version &&
+        header_->namesOffset <= header_->slotsOffset && header_->slotsOffset <= size_ &&
+        (size_ - header_->slotsOffset) / sizeof(SharedSlot) >= header_->slots;
+    if (!valid)
+    {
+        close();
+        return false;
+    }
+    slots_ = reinterpret_cast<SharedSlot*>(static_cast<char*>(base) + header_->slotsOffset);
+    return true;
+}
+
+void SharedStateSegment::close()
+{
+    if (base_)
+        ::munmap(base_, size_);
+    if (owner_)
+        ::shm_unlink(name_.c_str());
+    name_.clear();
+    base_ = nullptr;
+    size_ = 0;
+    header_ = nullptr;
+    slots_ = nullptr;
+    owner_ = false;
+}
+
+bool SharedStateSegment::remove(const std::string& name) { return ::shm_unlink(name.c_str()) == 0; }
+
+bool SharedStateReader::open(const std::string& name)
+{
+    close();
+    if (!segment_.open(name))
+        return false;
+    const SharedHeader& header = *segment_.header();
+    const char* names = reinterpret_cast<const char*>(&header) + header.namesOffset;
+    const char* end = reinterpret_cast<const char*>(&header) + header.slotsOffset;
+    for (uint32_t i = 0; i < header.states + header.events; ++i)
+    {
+        const void* zero = std::memchr(names, 0, static_cast<size_t>(end - names));
+        if (!zero)
+        {
+            close();
+            return false;
+        }
+        (i < header.states ? stateNames_ : eventNames_).push_back(names);
+        names = static_cast<const char*>(zero) + 1;
+    }
+    return true;
+}
+
+void SharedStateReader::close()
+{
+    segment_.close();
+    stateNames_.clear();
+    eventNames_.clear();
+}
+
+uint32_t SharedStateReader::slots() const { return segment_.header() ? segment_.header()->slots : 0; }
+
+bool SharedStateReader::read(uint32_t index, SharedSlotView& view, unsigned tries) const
+{
+    if (index >= slots())
+        return false;
+    const SharedSlot& slot = segment_.slot(index);
+    for (unsigned i = 0; i < tries; ++i)
+    {
+        const uint32_t before = slot.sequence.load(std::memory_order_acquire);
+        if (before & 1)
+            continue;
+        view.state = slot.state.load(std::memory_order_relaxed);
+        view.event = slot.event.load(std::memory_order_relaxed);
+        view.transitions = slot.transitions.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.sequence.load(std::memory_order_relaxed) == before)
+            return true;
+    }
+    return false;
+}
+
+size_t SharedStateReader::snapshot(std::vector<SharedSlotView>& views) const
+{
+    views.resize(slots());
+    size_t failed = 0;
+    for (uint32_t i = 0; i < slots(); ++i)
+        if (!read(i, views[i]))
+        {
+            views[i] = SharedSlotView{SharedSlot::none, SharedSlot::none, 0};
+            ++failed;
+        }
+    return failed;
+}
+
+} // namespace states
+
+#endif
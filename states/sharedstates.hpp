@@ -0,0 +1,250 @@
+//
+//  sharedstates.hpp
+//  states
+//
+//  Created by Daniel Pav on 10/19/26.
+//  Copyright © 2026 Daniel Pav. All rights reserved.
+//
+
+#pragma once
+
+#if defined(__unix__) || defined(__APPLE__)
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "named.hpp"
+#include "typelist.hpp"
+
+namespace states
+{
+/* the slot of a process in a shared state segment.  the owner makes sequence odd, writes the other fields and makes it
+ even again, so a reader that sees the same even sequence before and after reading the fields has a consistent copy.
+ each slot has a cache line to itself, so the threads writing neighbouring slots do not share lines */
+struct alignas(64) SharedSlot
+{
+    /* odd while the slot is being written */
+    std::atomic<uint32_t> sequence;
+    /* the index of the state, none for no state */
+    std::atomic<uint32_t> state;
+    /* the index of the last event followed, none for none */
+    std::atomic<uint32_t> event;
+    /* the number of transitions, wrapping */
+    std::atomic<uint32_t> transitions;
+
+    /* no state or event */
+    static const constexpr uint32_t none = 0xffffffffu;
+};
+
+/* a copy of a slot read from a shared state segment */
+struct SharedSlotView
+{
+    uint32_t state;
+    uint32_t event;
+    uint32_t transitions;
+};
+
+/* the start of a shared state segment.  it is followed by the names of the states and then of the events, in index
+ order and each ending with a 0, and then, at slotsOffset, by the slots */
+struct SharedHeader
+{
+    /* "STATESHM" */
+    char magic[8];
+    /* the version of the layout */
+    uint32_t version;
+    /* the number of slots */
+    uint32_t slots;
+    /* the number of states */
+    uint32_t states;
+    /* the number of events */
+    uint32_t events;
+    /* the offset of the names from the start */
+    uint32_t namesOffset;
+    /* the offset of the slots from the start */
+    uint32_t slotsOffset;
+    /* set to 1 once the rest of the segment has been written */
+    std::atomic<uint32_t> ready;
+};
+
+/* a POSIX shared memory segment holding the slots of a shared state table and the names to decode them */
+class SharedStateSegment
+{
+public:
+    /* the version of the layout */
+    static const constexpr uint32_t version = 2;
+
+    SharedStateSegment() = default;
+    ~SharedStateSegment() { close(); }
+    SharedStateSegment(const SharedStateSegment&) = delete;
+    SharedStateSegment& operator=(const SharedStateSegment&) = delete;
+
+public:
+    /* creates the segment with the name ("/name") with the names and the slots, all with no state.  the segment is
+     removed when closed.  returns false on failure, also if a segment with the name exists, as it may be mapped by
+     readers: a segment left by a process that did not close it must be removed first */
+    bool create(const std::string& name, uint32_t slots, const char* const* stateNames, uint32_t states,
+                const char* const* eventNames, uint32_t events);
+    /* opens the segment with the name to read it.  returns false if it does not exist or is not ready */
+    bool open(const std::string& name);
+    /* unmaps the segment, removing it if it was created */
+    void close();
+    /* removes the segment with the name, returns false if there is none.  readers that have it mapped keep it */
+    static bool remove(const std::string& name);
+
+    /* returns the header, nullptr if not open */
+    const SharedHeader* header() const { return header_; }
+    /* returns the slot at the index */
+    SharedSlot& slot(uint32_t index) const { return slots_[index]; }
+
+private:
+    /* the name, to remove it on close if it was created */
+    std::string name_;
+    /* the mapping */
+    void* base_{nullptr};
+    /* the size of the mapping */
+    size_t size_{0};
+    /* the header at the start of the mapping */
+    SharedHeader* header_{nullptr};
+    /* the slots in the mapping */
+    SharedSlot* slots_{nullptr};
+    /* true if created here */
+    bool owner_{false};
+};
+
+/* the states of a pool of processes of TMachine published in a shared memory segment, so that other OS processes can
+ see them (see SharedStateReader) without the machine types.  there is a slot for each process, written by the thread
+ that runs it without locks: a write never waits for a reader, readers retry until they get a consistent copy.  the
+ segment holds the names of the states and events in index order, so a slot can be decoded by name.  POSIX only.
+ */
+template<typename TMachine>
+class SharedStateTable
+{
+public:
+    /* creates the segment with the name ("/name") and the number of slots.  returns false on failure, also if a
+     segment with the name exists (see remove) */
+    bool create(const std::string& name, uint32_t slots)
+    {
+        const char* stateNames[TMachine::stateCount];
+        const char* eventNames[TMachine::eventCount];
+        for (size_t s = 0; s < TMachine::stateCount; ++s)
+            stateNames[s] = NamedAt<typename TMachine::TStateTypes>::name(s);
+        for (size_t e = 0; e < TMachine::eventCount; ++e)
+            eventNames[e] = NamedAt<typename TMachine::TEventTypes>::name(e);
+        return segment_.create(name, slots, stateNames, static_cast<uint32_t>(TMachine::stateCount), eventNames,
+                               static_cast<uint32_t>(TMachine::eventCount));
+    }
+
+    /* removes the segment */
+    void close() { segment_.close(); }
+
+    /* removes the segment with the name left by a process that did not close it, returns false if there is none */
+    static bool remove(const std::string& name) { return SharedStateSegment::remove(name); }
+
+    /* returns the number of slots, 0 if not created */
+    uint32_t slots() const { return segment_.header() ? segment_.header()->slots : 0; }
+
+    /* writes the state index and the event index to the slot.  one thread at a time for each slot */
+    void write(uint32_t index, size_t state, size_t event, bool transition)
+    {
+        if (index >= slots())
+            return;
+        SharedSlot& slot = segment_.slot(index);
+        const uint32_t sequence = slot.sequence.load(std::memory_order_relaxed);
+        slot.sequence.store(sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        slot.state.store(encode(state), std::memory_order_relaxed);
+        slot.event.store(encode(event), std::memory_order_relaxed);
+        if (transition)
+            slot.transitions.store(slot.transitions.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        slot.sequence.store(sequence + 2, std::memory_order_release);
+    }
+
+private:
+    /* returns the index as stored, none for npos */
+    static uint32_t encode(size_t index)
+    {
+        return (index < SharedSlot::none) ? static_cast<uint32_t>(index) : SharedSlot::none;
+    }
+
+private:
+    /* the segment */
+    SharedStateSegment segment_;
+};
+
+/* an observer that publishes the state of its process in a slot of a SharedStateTable */
+template<typename TMachine>
+class SharedStateWriter
+{
+public:
+    SharedStateWriter(SharedStateTable<TMachine>& table, uint32_t slot) : table_(&table), slot_(slot) {}
+
+public:
+    /* publishes the begin state */
+    template<typename TStateNum>
+    void onStart(const TStateNum& state)
+    {
+        table_->write(slot_, state.get(), TypeListIndexBase::npos, false);
+    }
+
+    /* publishes the new state and the event */
+    template<typename TStateNum, typename TEventNum>
+    void onTransition(const TStateNum&, const TEventNum& event, const TStateNum& to)
+    {
+        table_->write(slot_, to.get(), event.get(), true);
+    }
+
+    /* publishes no state */
+    template<typename TStateNum>
+    void onReset(const TStateNum&)
+    {
+        table_->write(slot_, TypeListIndexBase::npos, TypeListIndexBase::npos, false);
+    }
+
+private:
+    /* the table written to */
+    SharedStateTable<TMachine>* table_;
+    /* the slot of the process */
+    uint32_t slot_;
+};
+
+/* reads a segment of a SharedStateTable from another OS process, without the machine types.  POSIX only */
+class SharedStateReader
+{
+public:
+    /* opens the segment with the name, returns false if it does not exist or is not a shared state segment */
+    bool open(const std::string& name);
+    /* closes the segment */
+    void close();
+
+    /* returns the number of slots */
+    uint32_t slots() const;
+    /* returns the number of states */
+    uint32_t states() const { return static_cast<uint32_t>(stateNames_.size()); }
+    /* returns the number of events */
+    uint32_t events() const { return static_cast<uint32_t>(eventNames_.size()); }
+    /* returns the name of the state index, nullptr if it is not a state */
+    const char* stateName(uint32_t state) const { return (state < states()) ? stateNames_[state] : nullptr; }
+    /* returns the name of the event index, nullptr if it is not an event */
+    const char* eventName(uint32_t event) const { return (event < events()) ? eventNames_[event] : nullptr; }
+
+    /* copies the slot, retrying while it is being written up to tries times.  returns false if the slot is not a slot
+     or no consistent copy was read */
+    bool read(uint32_t index, SharedSlotView& view, unsigned tries = 1000) const;
+    /* copies every slot, returns the number that could not be read consistently (left with no state) */
+    size_t snapshot(std::vector<SharedSlotView>& views) const;
+
+private:
+    /* the segment */
+    SharedStateSegment segment_;
+    /* the names of the states in the segment */
+    std::vector<const char*> stateNames_;
+    /* the names of the events in the segment */
+    std::vector<const char*> eventNames_;
+};
+
+} // namespace states
+
+#endif
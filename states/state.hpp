@@ -7,39 +7,72 @@
 //
 #pragma once
 
+#include "invoker.hpp"
 #include "named.hpp"
 #include "noop.hpp"
 #include "typenum.hpp"
 
 namespace states
 {
-/* models a state by which has a name and an operation that is run on becoming that state */
-template<const char* TName, typename TStateOp = NoOp>
+/* the events a state defers: kept by a DeferringProcess until it is in a state that accepts them */
+template<typename... TEvents>
+struct Deferred
+{
+};
+
+/* models a state by which has a name and an operation that is run on becoming that state.  TStateData is the type of
+ the data the state has for itself while a process is in it, void for none (see StateData).  TDeferred is the list of
+ events it defers (see DeferringProcess) */
+template<const char* TName, typename TStateOp = NoOp, typename TStateData = void, typename TDeferred = Deferred<>>
 class State
 {
 private:
     /* this type */
-    using TThisType = State<TName, TStateOp>;
+    using TThisType = State<TName, TStateOp, TStateData, TDeferred>;
     /* the implementation of the name */
     using TNameImpl = Named<TName>;
 
+public:
+    /* the state op type */
+    using TStateOpType = TStateOp;
+    /* the state data type */
+    using TStateDataType = TStateData;
+    /* the deferred events */
+    using TDeferredType = TDeferred;
+
 public:
     /* returns the name of the state (as given by template paramter) */
-    static const char* name() { return TNameImpl::name(); }
+    static constexpr const char* name() { return TNameImpl::name(); }
 
     /* runs the state operation on the data provided */
     template<typename TData>
-    static void invoke(TData& data)
+    static constexpr void invoke(TData& data)
     {
-        TStateOp()(data);
+        DirectInvoker invoker{};
+        invoke(data, invoker);
+    }
+
+    /* runs the state operation on the data provided through the invoker */
+    template<typename TData, typename TInvoker>
+    static constexpr void invoke(TData& data, TInvoker& invoker)
+    {
+        invoker.template invoke<TThisType, TStateOp>(data);
     }
 
     /* sets the state to this state and invokes the state operation on the data provided */
     template<typename TData, typename... Ts>
-    static void become(TypeNum<Ts...>& state, TData& data)
+    static constexpr void become(TypeNum<Ts...>& state, TData& data)
+    {
+        DirectInvoker invoker{};
+        become(state, data, invoker);
+    }
+
+    /* sets the state to this state and invokes the state operation on the data provided through the invoker */
+    template<typename TData, typename TInvoker, typename... Ts>
+    static constexpr void become(TypeNum<Ts...>& state, TData& data, TInvoker& invoker)
     {
         state.template set<TThisType>();
-        invoke(data);
+        invoke(data, invoker);
     }
 
     /* visit the state using its name */
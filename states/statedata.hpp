@@ -0,0 +1,260 @@
+//
+//  statedata.hpp
+//  states
+//
+//  Created by Daniel Pav on 10/19/26.
+//  Copyright © 2026 Daniel Pav. All rights reserved.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+
+#include "noop.hpp"
+#include "typelist.hpp"
+#include "wildcard.hpp"
+
+namespace states
+{
+/* the size and alignment of a state data type T, 0 and 1 for void */
+template<typename T>
+struct StateDataSize
+{
+    static const constexpr size_t size = sizeof(T);
+    static const constexpr size_t align = alignof(T);
+};
+
+template<>
+struct StateDataSize<void>
+{
+    static const constexpr size_t size = 0;
+    static const constexpr size_t align = 1;
+};
+
+/* the largest size and alignment of the data types of the states in the type list TList */
+template<typename TList>
+struct StateDataLayout
+{
+    using TFirst = StateDataSize<typename TList::TCurrentType::TStateDataType>;
+    using TRest = StateDataLayout<typename TList::TNextType>;
+    static const constexpr size_t size = (TFirst::size > TRest::size) ? TFirst::size : TRest::size;
+    static const constexpr size_t align = (TFirst::align > TRest::align) ? TFirst::align : TRest::align;
+};
+
+template<>
+struct StateDataLayout<TypeListEnd>
+{
+    static const constexpr size_t size = 0;
+    static const constexpr size_t align = 1;
+};
+
+/* the data of a process of TMachine split in two: TShared, which the process has all the time, and the data of the
+ state it is in, declared by the state (see State), which only exists while the process is in that state.  the data of
+ the states share one buffer sized and aligned for the largest of them, so a process only pays for the state it is in.
+ use it as the data of a process with a StateDataInvoker, which enters each state as the process becomes it: the data
+ of the state left is destroyed and the data of the new state is default constructed.  the data is kept through a link
+ from a state to itself, and a start constructs the data of the begin state afresh.  it is destroyed by leave, with this
+ or, with a StateDataObserver as the observer of the process, when the process is reset.
+ */
+template<typename TMachine, typename TShared>
+class StateData
+{
+public:
+    /* the shared data type */
+    using TSharedType = TShared;
+    /* the sizes of the data of the states */
+    using TLayout = StateDataLayout<typename TMachine::TStateTypes>;
+    /* no state */
+    static const constexpr size_t npos = TypeListIndexBase::npos;
+
+    StateData(const TShared& shared = TShared()) : shared_(shared) {}
+    ~StateData() { leave(); }
+
+private:
+    StateData(const StateData&) = delete;
+    StateData& operator=(const StateData&) = delete;
+
+    /* destroys a T in the buffer */
+    template<typename T>
+    static void destroy(void* p)
+    {
+        static_cast<T*>(p)->~T();
+    }
+
+    /* constructs the data of a state with data */
+    template<typename TStateData>
+    void construct(std::false_type)
+    {
+        new (buffer_) TStateData();
+        destroy_ = &destroy<TStateData>;
+    }
+
+    /* a state without data has nothing to construct */
+    template<typename TStateData>
+    void construct(std::true_type)
+    {
+    }
+
+public:
+    /* returns the shared data */
+    TShared& shared() { return shared_; }
+    /* returns the shared data */
+    const TShared& shared() const { return shared_; }
+
+    /* returns the index of the state whose data is held, npos if none */
+    size_t state() const { return state_; }
+
+    /* returns the data of the state TState if it is the state entered, nullptr otherwise */
+    template<typename TState>
+    typename std::enable_if<TypeListContains<typename TMachine::TStateTypes, TState>::value &&
+                                !std::is_void<typename TState::TStateDataType>::value,
+                            typename TState::TStateDataType*>::type
+    get()
+    {
+        using TStateData = typename TState::TStateDataType;
+        const bool at = (state_ == TypeListIndex<typename TMachine::TStateTypes, TState>::index);
+        return at ? static_cast<TStateData*>(static_cast<void*>(buffer_)) : nullptr;
+    }
+
+    /* enters the state TState: unless it is the state entered, destroys the data of that state and constructs the data
+     of TState */
+    template<typename TState>
+    typename std::enable_if<TypeListContains<typename TMachine::TStateTypes, TState>::value>::type enter()
+    {
+        const size_t state = TypeListIndex<typename TMachine::TStateTypes, TState>::index;
+        if (state == state_)
+            return;
+        leave();
+        using TStateData = typename TState::TStateDataType;
+        construct<TStateData>(std::is_void<TStateData>());
+        state_ = state;
+    }
+
+    /* destroys the data of the state entered, if any, and leaves it */
+    void leave()
+    {
+        if (destroy_)
+            destroy_(buffer_);
+        destroy_ = nullptr;
+        state_ = npos;
+    }
+
+private:
+    /* the data of the state entered */
+    alignas(TLayout::align) unsigned char buffer_[TLayout::size ? TLayout::size : 1];
+    /* destroys the data in the buffer, nullptr if there is none */
+    void (*destroy_)(void*){nullptr};
+    /* the index of the state entered, npos for none */
+    size_t state_{npos};
+    /* the shared data */
+    TShared shared_;
+};
+
+/* runs the ops of a process of TMachine with StateData as its data.  before the op of a state is run the state is
+ entered, so its data is constructed.  a state op run without a link before it, by start or invoke, enters the state
+ afresh, destroying the data it had.  an op is called with the shared data and the data of its state: for a state op
+ the state, for a link op the from state, the state the process is leaving.  an op whose state has no data, a link op
+ from AnyState and NoOp are called with the shared data only.
+ */
+template<typename TMachine>
+struct StateDataInvoker
+{
+private:
+    /* the state whose data goes with the op of TOwner: the owner for a state, the from state for a link */
+    template<typename TOwner, bool TState = TypeListContains<typename TMachine::TStateTypes, TOwner>::value>
+    struct Scope
+    {
+        using TType = TOwner;
+    };
+
+    template<typename TOwner>
+    struct Scope<TOwner, false>
+    {
+        using TType = typename TOwner::TFromType;
+    };
+
+    /* enters the state before its op, leaving it first unless a link was followed to it */
+    template<typename TOwner, typename TData>
+    void enter(TData& data, std::true_type)
+    {
+        if (!linked_)
+            data.leave();
+        data.template enter<TOwner>();
+        linked_ = false;
+    }
+
+    /* a link is not entered, the op of the state it goes to comes next */
+    template<typename TOwner, typename TData>
+    void enter(TData&, std::false_type)
+    {
+        linked_ = true;
+    }
+
+    /* calls the op with the shared data and the data of its state */
+    template<typename TScope, typename TOp, typename TData>
+    static void call(TData& data, std::false_type)
+    {
+        TOp()(data.shared(), *data.template get<TScope>());
+    }
+
+    /* calls the op with the shared data only */
+    template<typename TScope, typename TOp, typename TData>
+    static void call(TData& data, std::true_type)
+    {
+        TOp()(data.shared());
+    }
+
+public:
+    /* runs the operation TOp of TOwner on the data, entering TOwner first if it is a state */
+    template<typename TOwner, typename TOp, typename TData>
+    void invoke(TData& data)
+    {
+        using TScope = typename Scope<TOwner>::TType;
+        using TShared = std::integral_constant<bool, std::is_void<typename TScope::TStateDataType>::value ||
+                                                         std::is_same<TOp, NoOp>::value>;
+        using TState = std::integral_constant<bool, TypeListContains<typename TMachine::TStateTypes, TOwner>::value>;
+        enter<TOwner>(data, TState());
+        call<TScope, TOp>(data, TShared());
+    }
+
+private:
+    /* true between the op of a link and the op of the state it goes to */
+    bool linked_{false};
+};
+
+/* an observer for a process with StateData as its data that destroys the data of the state when the process is reset,
+ so the data of the end state does not outlive the run */
+template<typename TMachine, typename TShared>
+class StateDataObserver
+{
+public:
+    StateDataObserver(StateData<TMachine, TShared>& data) : data_(&data) {}
+
+public:
+    /* does nothing, the begin state is entered by its op */
+    template<typename TStateNum>
+    void onStart(const TStateNum&)
+    {
+    }
+
+    /* does nothing, the new state is entered by its op */
+    template<typename TStateNum, typename TEventNum>
+    void onTransition(const TStateNum&, const TEventNum&, const TStateNum&)
+    {
+    }
+
+    /* the state is left, destroy its data */
+    template<typename TStateNum>
+    void onReset(const TStateNum&)
+    {
+        data_->leave();
+    }
+
+private:
+    /* the data of the process */
+    StateData<TMachine, TShared>* data_;
+};
+
+} // namespace states
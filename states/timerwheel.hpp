@@ -0,0 +1,375 @@
+//
+//  timerwheel.hpp
+//  states
+//
+//  Created by Daniel Pav on 10/19/26.
+//  Copyright © 2026 Daniel Pav. All rights reserved.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace states
+{
+/* identifies an armed timer.  ids are never reused: cancelling a timer that has expired or was cancelled already is
+ detected and does nothing */
+class TimerId
+{
+public:
+    TimerId() = default;
+    TimerId(uint32_t index, uint32_t generation) : index_(index), generation_(generation) {}
+
+public:
+    /* returns true if the id was returned by a successful arm */
+    bool valid() const { return generation_ != 0; }
+    /* returns the slot of the timer in the wheel */
+    uint32_t index() const { return index_; }
+    /* returns the generation of the slot when the timer was armed */
+    uint32_t generation() const { return generation_; }
+
+private:
+    uint32_t index_{0};
+    uint32_t generation_{0};
+};
+
+/* forward declare */
+template<typename TMachine>
+class TimerWheel;
+
+/* an observer for a process that owns the timers armed for the state the process is in.  any transition out of the
+ state (including a link back to the same state) and any reset cancels them.  they are also cancelled when the scope
+ is destroyed.  use it as the TObserver of the process and pass it to TimerWheel::armInState */
+template<typename TMachine>
+class TimerScope
+{
+public:
+    TimerScope(TimerWheel<TMachine>& wheel) : wheel_(&wheel) {}
+    /* copying a scope gives a new scope on the same wheel with no timers */
+    TimerScope(const TimerScope& other) : wheel_(other.wheel_) {}
+    TimerScope& operator=(const TimerScope&) = delete;
+    ~TimerScope() { cancel(); }
+
+public:
+    /* does nothing, there are no timers before the start */
+    template<typename TStateNum>
+    void onStart(const TStateNum&)
+    {
+    }
+
+    /* the from state is left, cancel its timers */
+    template<typename TStateNum, typename TEventNum>
+    void onTransition(const TStateNum&, const TEventNum&, const TStateNum&)
+    {
+        cancel();
+    }
+
+    /* the state is left, cancel its timers */
+    template<typename TStateNum>
+    void onReset(const TStateNum&)
+    {
+        cancel();
+    }
+
+    /* cancels the timers of the current state */
+    void cancel();
+
+private:
+    friend class TimerWheel<TMachine>;
+
+    /* the wheel the timers are armed on */
+    TimerWheel<TMachine>* wheel_;
+    /* first of the timers of the current state */
+    uint32_t head_{UINT32_MAX};
+};
+
+/* a hierarchical timing wheel delivering events to processes after a delay.  time is counted in ticks of whatever unit
+ the caller chooses, and only moves when advance is called.  there are 4 levels of 256 slots, so timers up to 2^32 ticks
+ away are placed directly and further ones are moved down as time approaches.  arm and cancel are O(1) and never
+ allocate: the timers come from a pool sized at construction.  advance takes the expired timers out of the wheel one
+ at a time and delivers each by calling next with the event on the process before taking the next, so a delivery may
+ arm and cancel timers, leave a state whose other timers have also expired, or destroy a process with its scope, and
+ the timers cancelled are not delivered.
+ */
+template<typename TMachine>
+class TimerWheel
+{
+public:
+    /* the event num type of the machine */
+    using TEventNum = typename TMachine::TEventNum;
+
+private:
+    /* bits of time per level, slots per level and number of levels */
+    static const constexpr unsigned levelBits = 8;
+    static const constexpr uint32_t slots = uint32_t(1) << levelBits;
+    static const constexpr unsigned levels = 4;
+    /* marks the end of a list */
+    static const constexpr uint32_t nil = UINT32_MAX;
+
+    /* delivers an event to a process of the type given when armed */
+    using TDeliver = bool (*)(void*, const TEventNum&);
+
+    /* a timer, linked in a slot of the wheel (or the free list) and in the scope that owns it, if any */
+    struct Node
+    {
+        uint64_t deadline{0};
+        void* target{nullptr};
+        TDeliver deliver{nullptr};
+        TimerScope<TMachine>* scope{nullptr};
+        TEventNum event{};
+        uint32_t prev{nil};
+        uint32_t next{nil};
+        uint32_t scopePrev{nil};
+        uint32_t scopeNext{nil};
+        uint32_t slot{nil};
+        uint32_t generation{1};
+    };
+
+    /* delivers the event by calling next on the process */
+    template<typename TProcess>
+    static bool deliverTo(void* target, const TEventNum& event)
+    {
+        return static_cast<TProcess*>(target)->next(event);
+    }
+
+public:
+    /* creates a wheel at tick 0 with room for capacity armed timers */
+    TimerWheel(size_t capacity) : nodes_(capacity)
+    {
+        for (uint32_t i = 0; i < slots * levels; ++i)
+            heads_[i] = nil;
+        for (size_t i = capacity; i != 0; --i)
+            release(static_cast<uint32_t>(i - 1));
+    }
+    TimerWheel(const TimerWheel&) = delete;
+    TimerWheel& operator=(const TimerWheel&) = delete;
+
+public:
+    /* returns the current tick */
+    uint64_t now() const { return now_; }
+    /* returns the number of armed timers */
+    size_t armed() const { return armed_; }
+
+    /* arms a timer to deliver the event to the process after delay ticks (at least 1), returns an invalid id if there is
+     no room.  the timer must be cancelled if the process goes away before it expires */
+    template<typename TProcess>
+    TimerId arm(TProcess& process, const TEventNum& event, uint64_t delay)
+    {
+        return armImpl(&process, &deliverTo<TProcess>, event, delay, nullptr);
+    }
+
+    /* arms a timer like arm, owned by the scope so that it is cancelled when the process leaves its current state.
+     scope is normally the observer of the process */
+    template<typename TProcess>
+    TimerId armInState(TProcess& process, TimerScope<TMachine>& scope, const TEventNum& event, uint64_t delay)
+    {
+        return armImpl(&process, &deliverTo<TProcess>, event, delay, &scope);
+    }
+
+    /* cancels the timer, returns false if it already expired or was cancelled */
+    bool cancel(const TimerId& id)
+    {
+        if (!id.valid() || id.index() >= nodes_.size() || nodes_[id.index()].generation != id.generation())
+            return false;
+        cancel(id.index());
+        return true;
+    }
+
+    /* moves time forward to now, delivering the events of every timer with a deadline up to now.  returns the number of
+     events delivered */
+    size_t advance(uint64_t now)
+    {
+        size_t delivered = 0;
+        while (now_ < now)
+        {
+            if (armed_ == 0)
+            {
+                now_ = now;
+                break;
+            }
+            skip(now);
+            ++now_;
+            cascade();
+            delivered += expire(static_cast<uint32_t>(now_ & (slots - 1)));
+        }
+        return delivered;
+    }
+
+private:
+    /* returns true if any slot of the level holds a timer */
+    bool occupied(unsigned level) const { return counts_[level] != 0; }
+
+    /* while the lowest levels are empty nothing happens until the next turn of the lowest occupied level, so moves time
+     to just before that turn when it is not past now */
+    void skip(uint64_t now)
+    {
+        for (unsigned level = 0; level + 1 < levels && !occupied(level); ++level)
+        {
+            const unsigned bits = levelBits * (level + 1);
+            const uint64_t turn = ((now_ >> bits) + 1) << bits;
+            if (turn > now)
+                return;
+            now_ = turn - 1;
+        }
+    }
+
+    TimerId armImpl(void* target, TDeliver deliver, const TEventNum& event, uint64_t delay,
+                    TimerScope<TMachine>* scope)
+    {
+        if (free_ == nil)
+            return TimerId();
+        const uint32_t index = free_;
+        Node& node = nodes_[index];
+        free_ = node.next;
+        node.deadline = now_ + (delay ? delay : 1);
+        node.target = target;
+        node.deliver = deliver;
+        node.event = event;
+        node.scope = scope;
+        if (scope)
+        {
+            node.scopePrev = nil;
+            node.scopeNext = scope->head_;
+            if (scope->head_ != nil)
+                nodes_[scope->head_].scopePrev = index;
+            scope->head_ = index;
+        }
+        place(index);
+        ++armed_;
+        return TimerId(index, node.generation);
+    }
+
+    /* puts the node in the slot for its deadline, the lowest level that can tell the deadline from now */
+    void place(uint32_t index)
+    {
+        Node& node = nodes_[index];
+        const uint64_t delta = node.deadline - now_;
+        unsigned level = 0;
+        while (level + 1 < levels && delta >= (uint64_t(1) << (levelBits * (level + 1))))
+            ++level;
+        const uint64_t limit = uint64_t(1) << (levelBits * levels);
+        const uint64_t when = (delta < limit) ? node.deadline : now_ + limit - 1;
+        const uint32_t slot = level * slots + static_cast<uint32_t>((when >> (levelBits * level)) & (slots - 1));
+        node.slot = slot;
+        node.prev = nil;
+        node.next = heads_[slot];
+        if (heads_[slot] != nil)
+            nodes_[heads_[slot]].prev = index;
+        heads_[slot] = index;
+        ++counts_[level];
+    }
+
+    /* takes the node out of its slot */
+    void unplace(uint32_t index)
+    {
+        Node& node = nodes_[index];
+        if (node.prev != nil)
+            nodes_[node.prev].next = node.next;
+        else
+            heads_[node.slot] = node.next;
+        if (node.next != nil)
+            nodes_[node.next].prev = node.prev;
+        --counts_[node.slot / slots];
+        node.slot = nil;
+    }
+
+    /* takes the node out of its scope, if any */
+    void unscope(uint32_t index)
+    {
+        Node& node = nodes_[index];
+        if (!node.scope)
+            return;
+        if (node.scopePrev != nil)
+            nodes_[node.scopePrev].scopeNext = node.scopeNext;
+        else
+            node.scope->head_ = node.scopeNext;
+        if (node.scopeNext != nil)
+            nodes_[node.scopeNext].scopePrev = node.scopePrev;
+        node.scope = nullptr;
+        node.scopePrev = nil;
+        node.scopeNext = nil;
+    }
+
+    /* returns the node to the free list, making its ids stale */
+    void release(uint32_t index)
+    {
+        Node& node = nodes_[index];
+        if (++node.generation == 0)
+            node.generation = 1;
+        node.next = free_;
+        free_ = index;
+    }
+
+    void cancel(uint32_t index)
+    {
+        unplace(index);
+        unscope(index);
+        release(index);
+        --armed_;
+    }
+
+    /* when a level wraps around, moves the timers of the next slot of the level above down to where they belong */
+    void cascade()
+    {
+        for (unsigned level = 1; level < levels; ++level)
+        {
+            if ((now_ & ((uint64_t(1) << (levelBits * level)) - 1)) != 0)
+                return;
+            const uint32_t slot = level * slots + static_cast<uint32_t>((now_ >> (levelBits * level)) & (slots - 1));
+            uint32_t index = heads_[slot];
+            while (index != nil)
+            {
+                const uint32_t next = nodes_[index].next;
+                unplace(index);
+                place(index);
+                index = next;
+            }
+        }
+    }
+
+    /* expires the timers in the slot of the lowest level one at a time, taking each out before delivering it.  the
+     head of the slot is read again after each delivery, which may have cancelled the timers after it */
+    size_t expire(uint32_t slot)
+    {
+        size_t delivered = 0;
+        while (heads_[slot] != nil)
+        {
+            const uint32_t index = heads_[slot];
+            const Node& node = nodes_[index];
+            void* const target = node.target;
+            const TDeliver deliver = node.deliver;
+            const TEventNum event = node.event;
+            cancel(index);
+            deliver(target, event);
+            ++delivered;
+        }
+        return delivered;
+    }
+
+private:
+    friend class TimerScope<TMachine>;
+
+    /* the pool of timers */
+    std::vector<Node> nodes_;
+    /* first timer of each slot of each level */
+    uint32_t heads_[slots * levels];
+    /* number of timers on each level */
+    size_t counts_[levels]{};
+    /* first free timer */
+    uint32_t free_{nil};
+    /* number of armed timers */
+    size_t armed_{0};
+    /* the current tick */
+    uint64_t now_{0};
+};
+
+template<typename TMachine>
+void TimerScope<TMachine>::cancel()
+{
+    while (head_ != UINT32_MAX)
+        wheel_->cancel(head_);
+}
+
+} // namespace states
@@ -166,6 +166,26 @@ struct TypeListUnique<T>
     using TNextType = TypeListEnd;
 };
 
+//
+// TypeListRemove
+//
+
+/* removes the first T from the type list TList, TType is the list without it */
+template<typename TList, typename T>
+struct TypeListRemove
+{
+    using TRest = typename TypeListRemove<typename TList::TNextType, T>::TType;
+    using TSame = std::is_same<typename TList::TCurrentType, T>;
+    using TType = typename std::conditional<TSame::value, typename TList::TNextType,
+                                            TypeListAdd<TRest, typename TList::TCurrentType>>::type;
+};
+
+template<typename T>
+struct TypeListRemove<TypeListEnd, T>
+{
+    using TType = TypeListEnd;
+};
+
 //
 // TypeListSize
 //
@@ -0,0 +1,223 @@
+//
+//  weightedmachine.hpp
+//  states
+//
+//  Created by Daniel Pav on 10/19/26.
+//  Copyright © 2026 Daniel Pav. All rights reserved.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <type_traits>
+
+#include "invoker.hpp"
+#include "typelist.hpp"
+#include "wildcard.hpp"
+
+/* marks a branch as rarely taken where the compiler supports it */
+#ifndef STATES_UNLIKELY
+#if (defined(_MSVC_LANG) && _MSVC_LANG >= 202002L) || __cplusplus >= 202002L
+#define STATES_UNLIKELY [[unlikely]]
+#else
+#define STATES_UNLIKELY
+#endif
+#endif
+
+namespace states
+{
+/* a weight for every link of a machine, in the order of its links.  0 marks a link that is never expected to be taken.
+ normally generated by LinkProfile::emit */
+template<size_t... TWeights>
+struct LinkWeights
+{
+    static const constexpr size_t size = sizeof...(TWeights);
+};
+
+/* a link with its weight */
+template<typename TLink, size_t TWeight>
+struct WeightedLink
+{
+    using TLinkType = TLink;
+    static const constexpr size_t weight = TWeight;
+    static const constexpr bool cold = (TWeight == 0);
+};
+
+/* pairs each link of the type list TLinks with its weight in TWeights, TType is the list of weighted links */
+template<typename TLinks, typename TWeights>
+struct WeighLinks;
+
+template<typename TLinks, size_t TWeight, size_t... TWeights>
+struct WeighLinks<TLinks, LinkWeights<TWeight, TWeights...>>
+{
+    using TRest = typename WeighLinks<typename TLinks::TNextType, LinkWeights<TWeights...>>::TType;
+    using TType = TypeListAdd<TRest, WeightedLink<typename TLinks::TCurrentType, TWeight>>;
+};
+
+template<typename TLinks>
+struct WeighLinks<TLinks, LinkWeights<>>
+{
+    using TType = TypeListEnd;
+};
+
+/* the first of the heaviest weighted links in the list TList */
+template<typename TList>
+struct HeaviestLink
+{
+    using TCurrent = typename TList::TCurrentType;
+    using TRest = typename HeaviestLink<typename TList::TNextType>::TType;
+    using TType = typename std::conditional<(TCurrent::weight >= TRest::weight), TCurrent, TRest>::type;
+};
+
+template<>
+struct HeaviestLink<TypeListEnd>
+{
+    using TType = WeightedLink<void, 0>;
+};
+
+/* the weighted links of the list TList from the heaviest to the lightest, keeping the order of links of equal weight */
+template<typename TList>
+struct SortByWeight
+{
+    using TFirst = typename HeaviestLink<TList>::TType;
+    using TRest = typename SortByWeight<typename TypeListRemove<TList, TFirst>::TType>::TType;
+    using TType = TypeListAdd<TRest, TFirst>;
+};
+
+template<>
+struct SortByWeight<TypeListEnd>
+{
+    using TType = TypeListEnd;
+};
+
+/* the machine TMachine with its links tried in the order of the weights TWeights, heaviest first, and the branches of
+ the links of weight 0 marked as unlikely.  instead of the table look up of TMachine::handle, handle is a chain of tests
+ in that order: a link with a from state and an event is taken when the state and the event are both its own, which no
+ other link can be more specific than, and only a wildcard link looks in the table of TMachine to see whether a more
+ specific link takes its place.  so the heaviest link costs one test and the order of the weights is the order of the
+ work done.  with handle<TEvent> the event is known at compile time and the tests of the links on other events fold
+ away.  the order does not change what the machine does: the states, the events and their indices are those of
+ TMachine, which is a base.  use it in place of TMachine, with weights from a LinkProfile of a typical run.
+ */
+template<typename TMachine, typename TWeights>
+class WeightedMachine : public TMachine
+{
+public:
+    /* the state num type */
+    using TStateNum = typename TMachine::TStateNum;
+    /* the event num type */
+    using TEventNum = typename TMachine::TEventNum;
+    /* the list of events */
+    using TEventTypes = typename TMachine::TEventTypes;
+    /* asserts there is a weight for every link */
+    static_assert(TWeights::size == TMachine::linkCount, "there must be a weight for every link");
+    /* the weighted links in the order they are tried */
+    using TWeightedLinks =
+        typename SortByWeight<typename WeighLinks<typename TMachine::TLinkList, TWeights>::TType>::TType;
+
+private:
+    /* follows the link */
+    template<typename TLink, typename TData, typename TInvoker>
+    static constexpr bool followImpl(TStateNum& state, TData& data, TInvoker& invoker)
+    {
+        TLink::follow(state, data, invoker);
+        return true;
+    }
+
+    /* tries a link that is expected to be taken */
+    template<typename TLink, typename TData, typename TInvoker>
+    static constexpr bool tryImpl(bool relevant, TStateNum& state, TData& data, TInvoker& invoker, std::false_type)
+    {
+        if (relevant)
+            return followImpl<TLink>(state, data, invoker);
+        return false;
+    }
+
+    /* tries a link that is not expected to be taken */
+    template<typename TLink, typename TData, typename TInvoker>
+    static constexpr bool tryImpl(bool relevant, TStateNum& state, TData& data, TInvoker& invoker, std::true_type)
+    {
+        if (relevant)
+            STATES_UNLIKELY
+            {
+                return followImpl<TLink>(state, data, invoker);
+            }
+        return false;
+    }
+
+    /* a link with a from state and an event, not a wildcard */
+    template<typename TLink>
+    using TExact = std::integral_constant<bool, !std::is_same<typename TLink::TFromType, AnyState>::value &&
+                                                    !std::is_same<typename TLink::TEventType, AnyEvent>::value>;
+
+    /* a link with a from state and an event is taken if the state and the event index are its own */
+    template<typename TLink>
+    static constexpr bool relevantImpl(const TStateNum& state, size_t event, std::true_type)
+    {
+        return event == TypeListIndex<TEventTypes, typename TLink::TEventType>::index &&
+            state.template is<typename TLink::TFromType>();
+    }
+
+    /* a wildcard link is taken if the table has it for the state and the event index, no more specific link does */
+    template<typename TLink>
+    static constexpr bool relevantImpl(const TStateNum& state, size_t event, std::false_type)
+    {
+        return TMachine::link(state.get(), event) == TypeListIndex<typename TMachine::TLinkList, TLink>::index;
+    }
+
+    /* link case for handle, if the link is taken for the state and the event index, follow it, else try the others */
+    template<typename TData, typename TInvoker, typename TList>
+    static constexpr bool handleImpl(size_t event, TStateNum& state, TData& data, TInvoker& invoker, const TList*)
+    {
+        using TFirst = typename TList::TCurrentType;
+        using TLink = typename TFirst::TLinkType;
+        using TCold = std::integral_constant<bool, TFirst::cold>;
+        const bool relevant = relevantImpl<TLink>(state, event, TExact<TLink>());
+        return tryImpl<TLink>(relevant, state, data, invoker, TCold()) ||
+            handleImpl(event, state, data, invoker, static_cast<const typename TList::TNextType*>(nullptr));
+    }
+
+    /* base case for handle, do nothing */
+    template<typename TData, typename TInvoker>
+    static constexpr bool handleImpl(size_t event, TStateNum& state, TData& data, TInvoker& invoker,
+                                     const TypeListEnd*)
+    {
+        return false;
+    }
+
+public:
+    /* handle an event as Machine::handle, trying the links in the order of their weights */
+    template<typename TEvent, typename TData>
+    static constexpr typename std::enable_if<TypeListContains<TEventTypes, TEvent>::value, bool>::type handle(
+        TStateNum& state, TData& data)
+    {
+        DirectInvoker invoker{};
+        return handle<TEvent>(state, data, invoker);
+    }
+
+    /* handle an event as above, running the ops through the invoker */
+    template<typename TEvent, typename TData, typename TInvoker>
+    static constexpr typename std::enable_if<TypeListContains<TEventTypes, TEvent>::value, bool>::type handle(
+        TStateNum& state, TData& data, TInvoker& invoker)
+    {
+        return handleImpl(TypeListIndex<TEventTypes, TEvent>::index, state, data, invoker,
+                          static_cast<const TWeightedLinks*>(nullptr));
+    }
+
+    /* handles the transition as Machine::handle, trying the links in the order of their weights */
+    template<typename TData>
+    static constexpr bool handle(TStateNum& state, const TEventNum& event, TData& data)
+    {
+        DirectInvoker invoker{};
+        return handle(state, event, data, invoker);
+    }
+
+    /* handles the transition as above, running the ops through the invoker */
+    template<typename TData, typename TInvoker>
+    static constexpr bool handle(TStateNum& state, const TEventNum& event, TData& data, TInvoker& invoker)
+    {
+        return handleImpl(event.get(), state, data, invoker, static_cast<const TWeightedLinks*>(nullptr));
+    }
+};
+
+} // namespace states
@@ -0,0 +1,13 @@
+//
+//  wildcard.cpp
+//  states
+//
+//  Created by Daniel Pav on 10/19/26.
+//  Copyright © 2026 Daniel Pav. All rights reserved.
+//
+
+#include "wildcard.hpp"
+
+namespace states
+{
+}
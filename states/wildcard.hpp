@@ -0,0 +1,96 @@
+//
+//  wildcard.hpp
+//  states
+//
+//  Created by Daniel Pav on 10/19/26.
+//  Copyright © 2026 Daniel Pav. All rights reserved.
+//
+
+#pragma once
+
+#include "noop.hpp"
+
+namespace states
+{
+/* the from state of a link that leaves every state of the machine.  it is not a state of the machine itself and a link
+ cannot go to it */
+class AnyState
+{
+public:
+    /* the state op type, it has no op */
+    using TStateOpType = NoOp;
+    /* the state data type, it has no data */
+    using TStateDataType = void;
+
+public:
+    /* returns the name used for any state */
+    static constexpr const char* name() { return "*"; }
+
+    /* visit as a state by its name */
+    template<typename TVisitor>
+    static void visit(TVisitor& visitor)
+    {
+        visitor.visitState(name());
+    }
+};
+
+/* the event of a link that is taken for every event of the machine.  it is not an event of the machine itself */
+class AnyEvent
+{
+public:
+    /* returns the name used for any event */
+    static constexpr const char* name() { return "*"; }
+
+    /* visit as an event by its name */
+    template<typename TVisitor>
+    static void visit(TVisitor& visitor)
+    {
+        visitor.visitEvent(name());
+    }
+};
+
+/* matches a state num against the from state TFrom of a link */
+template<typename TFrom>
+struct FromMatch
+{
+    template<typename TStateNum>
+    static constexpr bool test(const TStateNum& state)
+    {
+        return state.template is<TFrom>();
+    }
+};
+
+/* any state matches every valid state */
+template<>
+struct FromMatch<AnyState>
+{
+    template<typename TStateNum>
+    static constexpr bool test(const TStateNum& state)
+    {
+        return state.valid();
+    }
+};
+
+/* matches an event num against the event TEvent of a link */
+template<typename TEvent>
+struct EventMatch
+{
+    template<typename TEventNum>
+    static constexpr bool test(const TEventNum& event)
+    {
+        return event.template is<TEvent>();
+    }
+};
+
+/* any event matches every valid event */
+template<>
+struct EventMatch<AnyEvent>
+{
+    template<typename TEventNum>
+    static constexpr bool test(const TEventNum& event)
+    {
+        return event.valid();
+    }
+};
+
+} // namespace states
@@ -0,0 +1,115 @@
+//
+//  workload.cpp
+//  states
+//
+//  Created by Daniel Pav on 10/19/26.
+//  Copyright © 2026 Daniel Pav. All rights reserved.
+//
+
+#include "workload.hpp"
+
+#include <cstring>
+
+namespace states
+{
+namespace
+{
+/* marks the start of a trace */
+const char traceMagic[8] = {'S', 'T', 'A', 'T', 'E', 'T', 'R', 'C'};
+} // namespace
+
+bool TraceWriter::open(const std::string& name, uint32_t tag)
+{
+    close();
+    file_ = std::fopen(name.c_str(), "wb");
+    if (!file_)
+        return false;
+    uint8_t header[sizeof(traceMagic) + sizeof(tag)];
+    std::memcpy(header, traceMagic, sizeof(traceMagic));
+    std::memcpy(header + sizeof(traceMagic), &tag, sizeof(tag));
+    return std::fwrite(header, sizeof(header), 1, file_) == 1;
+}
+
+bool TraceWriter::append(const size_t* events, size_t n)
+{
+    if (!file_)
+        return false;
+    buffer_.resize((n + 1) * VarInt::maxSize);
+    size_t used = VarInt::put(buffer_.data(), n);
+    for (size_t i = 0; i < n; ++i)
+        used += VarInt::put(buffer_.data() + used, events[i]);
+    return std::fwrite(buffer_.data(), used, 1, file_) == 1;
+}
+
+bool TraceWriter::close()
+{
+    if (!file_)
+        return true;
+    const bool ok = std::fclose(file_) == 0;
+    file_ = nullptr;
+    return ok;
+}
+
+bool TraceReader::open(const std::string& name)
+{
+    close();
+    std::FILE* file = std::fopen(name.c_str(), "rb");
+    if (!file)
+        return false;
+    uint8_t chunk[1 << 16];
+    size_t n;
+    while ((n = std::fread(chunk, 1, sizeof(chunk), file)) != 0)
+        data_.insert(data_.end(), chunk, chunk + n);
+    const bool ok = !std::ferror(file);
+    std::fclose(file);
+    const size_t header = sizeof(traceMagic) + sizeof(tag_);
+    if (!ok || data_.size() < header || std::memcmp(data_.data(), traceMagic, sizeof(traceMagic)) != 0)
+    {
+        close();
+        return false;
+    }
+    std::memcpy(&tag_, data_.data() + sizeof(traceMagic), sizeof(tag_));
+    in_ = data_.data() + header;
+    return true;
+}
+
+bool TraceReader::get(uint64_t& value)
+{
+    return VarInt::get(in_, data_.data() + data_.size(), value);
+}
+
+size_t TraceReader::count()
+{
+    uint64_t n;
+    if (!in_ || !get(n))
+        return npos;
+    /* each event takes at least a byte, so a count larger than what is left is not a session */
+    const size_t left = static_cast<size_t>(data_.data() + data_.size() - in_);
+    return (n <= left) ? static_cast<size_t>(n) : npos;
+}
+
+bool TraceReader::next(std::vector<size_t>& events)
+{
+    events.clear();
+    const size_t n = count();
+    if (n == npos)
+        return false;
+    events.reserve(n);
+    for (size_t i = 0; i < n; ++i)
+    {
+        uint64_t event;
+        if (!get(event))
+            return false;
+        events.push_back(static_cast<size_t>(event));
+    }
+    return true;
+}
+
+void TraceReader::close()
+{
+    data_.clear();
+    data_.shrink_to_fit();
+    in_ = nullptr;
+    tag_ = 0;
+}
+} // namespace states
@@ -0,0 +1,379 @@
+//
+//  workload.hpp
+//  states
+//
+//  Created by Daniel Pav on 10/19/26.
+//  Copyright © 2026 Daniel Pav. All rights reserved.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "eventlog.hpp"
+#include "linkprofile.hpp"
+#include "typelist.hpp"
+
+namespace states
+{
+/* writes a trace file: sessions of event indices.  the file starts with a header holding a tag given by the user of
+ the trace, then each session is its number of events and the events, all as varints, so most events take one byte */
+class TraceWriter
+{
+public:
+    TraceWriter() = default;
+    ~TraceWriter() { close(); }
+    TraceWriter(const TraceWriter&) = delete;
+    TraceWriter& operator=(const TraceWriter&) = delete;
+
+public:
+    /* creates the file, replacing it if it exists.  returns false on failure */
+    bool open(const std::string& name, uint32_t tag);
+    /* appends a session of n event indices, returns false on failure */
+    bool append(const size_t* events, size_t n);
+    /* closes the file, returns false if it could not be written */
+    bool close();
+
+private:
+    std::FILE* file_{nullptr};
+    std::vector<uint8_t> buffer_;
+};
+
+/* reads a trace file written by TraceWriter.  open loads the whole file into memory, sessions are then decoded from
+ there one at a time */
+class TraceReader
+{
+public:
+    TraceReader() = default;
+    ~TraceReader() { close(); }
+    TraceReader(const TraceReader&) = delete;
+    TraceReader& operator=(const TraceReader&) = delete;
+
+public:
+    /* loads the file, returns false if it does not exist, could not be read or is not a trace */
+    bool open(const std::string& name);
+    /* returns the tag given to the writer */
+    uint32_t tag() const { return tag_; }
+    /* decodes the next session into events, returns false at the end of the trace or if it is cut short */
+    bool next(std::vector<size_t>& events);
+    /* decodes the next session as next does, into event nums.  an index that is not an event is left as no event */
+    template<typename TEventNum>
+    bool next(std::vector<TEventNum>& events)
+    {
+        events.clear();
+        const size_t n = count();
+        if (n == npos)
+            return false;
+        events.resize(n);
+        for (size_t i = 0; i < n; ++i)
+        {
+            uint64_t event;
+            if (!get(event))
+                return false;
+            events[i].set(static_cast<size_t>(event));
+        }
+        return true;
+    }
+    /* frees the trace */
+    void close();
+
+private:
+    /* no session */
+    static const constexpr size_t npos = TypeListIndexBase::npos;
+
+    /* decodes a varint, returns false at the end of the trace */
+    bool get(uint64_t& value);
+    /* decodes the number of events of a session, npos at the end of the trace or if there are not that many bytes
+     left */
+    size_t count();
+
+private:
+    /* the whole file */
+    std::vector<uint8_t> data_;
+    /* the next byte to decode, nullptr if not open */
+    const uint8_t* in_{nullptr};
+    uint32_t tag_{0};
+};
+
+/* the tag of the traces of TMachine: the format version and the number of events */
+template<typename TMachine>
+struct TraceFormat
+{
+    static const constexpr uint32_t tag = 0x01000000u | static_cast<uint32_t>(TMachine::eventCount);
+};
+
+/* makes up sessions for TMachine: random walks from TBegin to TEnd following its links.  each link has a weight, 1 to
+ start with, and a link is chosen from the links of the current state with a chance in proportion to its weight.  with
+ the chance set by rejections, an event the state does not accept is put in instead, which leaves the state as it was.
+ the length of a session is drawn from a distribution given to session: until a session has that many events it only
+ goes to TEnd from states with no other link, after that it takes the shortest way to TEnd.  a session ends at TEnd, at
+ a state without links or at max events.
+ */
+template<typename TMachine, typename TBegin, typename TEnd>
+class WorkloadGenerator
+{
+public:
+    /* number of states */
+    static const constexpr size_t states = TMachine::stateCount;
+    /* number of events */
+    static const constexpr size_t events = TMachine::eventCount;
+    /* number of links */
+    static const constexpr size_t links = TMachine::linkCount;
+    /* no state or event */
+    static const constexpr size_t npos = TypeListIndexBase::npos;
+
+private:
+    /* index of the begin state */
+    static const constexpr size_t begin = TypeListIndex<typename TMachine::TStateTypes, TBegin>::index;
+    /* index of the end state */
+    static const constexpr size_t end = TypeListIndex<typename TMachine::TStateTypes, TEnd>::index;
+
+public:
+    /* sets every weight to 1 and finds how far each state is from TEnd */
+    WorkloadGenerator() : rejections_(0)
+    {
+        for (size_t l = 0; l < links; ++l)
+            weights_[l] = 1;
+        for (size_t s = 0; s < states; ++s)
+            distance_[s] = npos;
+        distance_[end] = 0;
+        for (bool changed = true; changed;)
+        {
+            changed = false;
+            for (size_t s = 0; s < states; ++s)
+                for (size_t e = 0; e < events; ++e)
+                {
+                    const size_t to = TMachine::target(s, e);
+                    if (to != npos && distance_[to] != npos && distance_[to] + 1 < distance_[s])
+                    {
+                        distance_[s] = distance_[to] + 1;
+                        changed = true;
+                    }
+                }
+        }
+    }
+
+public:
+    /* sets the weight of the link at the index */
+    void weigh(size_t link, double weight)
+    {
+        if (link < links)
+            weights_[link] = weight;
+    }
+
+    /* sets the weight of every link to its count in the profile */
+    void weigh(const LinkProfile<TMachine>& profile)
+    {
+        for (size_t l = 0; l < links; ++l)
+            weights_[l] = static_cast<double>(profile.count(l));
+    }
+
+    /* sets the chance of putting in an event the state does not accept, 0 for none */
+    void reject(double chance) { rejections_ = chance; }
+
+    /* makes up a session with the random engine and the length distribution, appending its event indices to out.
+     returns the number of events appended */
+    template<typename TRandom, typename TLength>
+    size_t session(TRandom& random, TLength& length, std::vector<size_t>& out, size_t max = 1 << 20)
+    {
+        std::uniform_real_distribution<double> chance(0, 1);
+        const size_t target = static_cast<size_t>(length(random));
+        size_t state = begin;
+        size_t n = 0;
+        while (state != end && n < max)
+        {
+            if (rejections_ > 0 && chance(random) < rejections_)
+            {
+                const size_t event = pickRejected(random, state);
+                if (event != npos)
+                {
+                    out.push_back(event);
+                    ++n;
+                    continue;
+                }
+            }
+            const size_t event = pickLink(random, state, n >= target);
+            if (event == npos)
+                break;
+            out.push_back(event);
+            state = TMachine::target(state, event);
+            ++n;
+        }
+        return n;
+    }
+
+    /* makes up sessions and writes them to the trace, returns false if the trace could not be written */
+    template<typename TRandom, typename TLength>
+    bool write(TraceWriter& trace, TRandom& random, TLength& length, size_t sessions)
+    {
+        std::vector<size_t> events;
+        for (size_t i = 0; i < sessions; ++i)
+        {
+            events.clear();
+            session(random, length, events);
+            if (!trace.append(events.data(), events.size()))
+                return false;
+        }
+        return true;
+    }
+
+    /* returns the number of links on the shortest way from the state at the index to TEnd, npos if there is none */
+    size_t distance(size_t state) const { return (state < states) ? distance_[state] : npos; }
+
+private:
+    /* picks an event the state does not accept, npos if it accepts all */
+    template<typename TRandom>
+    size_t pickRejected(TRandom& random, size_t state)
+    {
+        size_t count = 0;
+        for (size_t e = 0; e < events; ++e)
+            count += (TMachine::target(state, e) == npos) ? 1 : 0;
+        if (count == 0)
+            return npos;
+        size_t pick = std::uniform_int_distribution<size_t>(0, count - 1)(random);
+        for (size_t e = 0; e < events; ++e)
+            if (TMachine::target(state, e) == npos && pick-- == 0)
+                return e;
+        return npos;
+    }
+
+    /* picks the event of a link from the state by weight.  when finishing, only from the links that get closest to
+     TEnd, otherwise not from the links to TEnd if there are others.  npos if the state has no links */
+    template<typename TRandom>
+    size_t pickLink(TRandom& random, size_t state, bool finishing)
+    {
+        size_t closest = npos;
+        bool other = false;
+        for (size_t e = 0; e < events; ++e)
+        {
+            const size_t to = TMachine::target(state, e);
+            closest = (to != npos && distance_[to] < closest) ? distance_[to] : closest;
+            other = other || (to != npos && to != end);
+        }
+        const size_t want = finishing ? closest : (other ? npos - 1 : npos);
+        double total = 0;
+        size_t count = 0;
+        for (size_t e = 0; e < events; ++e)
+            if (candidate(state, e, want))
+            {
+                total += weights_[TMachine::link(state, e)];
+                ++count;
+            }
+        if (count == 0)
+            return npos;
+        /* links of no weight are only taken when there is nothing else, then evenly */
+        double pick = std::uniform_real_distribution<double>(0, (total > 0) ? total : count)(random);
+        size_t last = npos;
+        for (size_t e = 0; e < events; ++e)
+            if (candidate(state, e, want))
+            {
+                last = e;
+                pick -= (total > 0) ? weights_[TMachine::link(state, e)] : 1;
+                if (pick < 0)
+                    return e;
+            }
+        return last;
+    }
+
+    /* returns true if the event has a link from the state that may be picked: any link if want is npos, a link not to
+     TEnd if it is npos - 1, else a link to a state at that distance from TEnd */
+    bool candidate(size_t state, size_t event, size_t want) const
+    {
+        const size_t to = TMachine::target(state, event);
+        if (to == npos)
+            return false;
+        if (want == npos)
+            return true;
+        return (want == npos - 1) ? to != end : distance_[to] == want;
+    }
+
+private:
+    /* the weight of each link */
+    double weights_[links];
+    /* the shortest distance of each state to TEnd */
+    size_t distance_[states];
+    /* the chance of a rejected event */
+    double rejections_;
+};
+
+/* what a replay did */
+struct TraceCount
+{
+    /* sessions read */
+    uint64_t sessions{0};
+    /* events read */
+    uint64_t events{0};
+    /* events the process accepted */
+    uint64_t accepted{0};
+    /* sessions that left the process done */
+    uint64_t done{0};
+};
+
+/* returns whether TProcess has the batch next(events, n) */
+template<typename TProcess, typename = void>
+struct HasBatchNext : std::false_type
+{
+};
+
+template<typename TProcess>
+struct HasBatchNext<TProcess, decltype(void(std::declval<TProcess&>().next(
+                                  static_cast<const typename TProcess::TEventNum*>(nullptr), size_t(0))))>
+    : std::true_type
+{
+};
+
+/* gives the n events to the process with the batch next, passing over each event it does not accept.  returns the
+ number accepted */
+template<typename TProcess>
+uint64_t replayEvents(TProcess& process, const typename TProcess::TEventNum* events, size_t n, std::true_type)
+{
+    uint64_t accepted = 0;
+    for (size_t i = 0; i < n; ++i)
+    {
+        const size_t done = process.next(events + i, n - i);
+        accepted += done;
+        i += done;
+    }
+    return accepted;
+}
+
+/* gives the n events to the process one at a time.  returns the number accepted */
+template<typename TProcess>
+uint64_t replayEvents(TProcess& process, const typename TProcess::TEventNum* events, size_t n, std::false_type)
+{
+    uint64_t accepted = 0;
+    for (size_t i = 0; i < n; ++i)
+        accepted += process.next(events[i]) ? 1 : 0;
+    return accepted;
+}
+
+/* replays every session of the trace on the process: each session is decoded, then resets and starts the process and
+ gives it the events, with the batch next if the process has one and else with next(TEventNum).  returns what
+ happened, or nothing if the trace is not for the machine of the process */
+template<typename TProcess>
+TraceCount replayTrace(TraceReader& trace, TProcess& process)
+{
+    TraceCount count;
+    if (trace.tag() != TraceFormat<typename TProcess::TMachineType>::tag)
+        return count;
+    std::vector<typename TProcess::TEventNum> events;
+    while (trace.next(events))
+    {
+        ++count.sessions;
+        count.events += events.size();
+        process.reset();
+        process.start();
+        count.accepted += replayEvents(process, events.data(), events.size(), HasBatchNext<TProcess>());
+        count.done += process.done() ? 1 : 0;
+    }
+    return count;
+}
+
+} // namespace states